@@ -3,6 +3,27 @@
 #include <cstdlib>  // для rand() и srand()
 #include <ctime>  // для time()
 #include <locale>
+#include <cstdint>
+#include <cstddef>
+#include <istream>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
 
 
 int processArray(double arr[], int size, int a, int b, std::vector<double>& nElements) {
@@ -26,7 +47,362 @@ int processArray(double arr[], int size, int a, int b, std::vector<double>& nEle
     return nCount;
 }
 
-int main() {
+// Размер блока, на которые делится массив в параллельной версии.
+// Не зависит от числа потоков, поэтому разбиение всегда одинаковое.
+const size_t CHUNK_SIZE = 1 << 16;
+
+// Счетчиковый генератор (SplitMix64): случайное число зависит только от seed и
+// глобального индекса элемента, а не от порядка вызовов
+inline uint64_t counterRandom(uint64_t seed, uint64_t counter) {
+    uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Множитель для элемента с индексом index из диапазона [a, b]
+inline double randomFactor(uint64_t seed, uint64_t index, int a, int b) {
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(b) - a + 1);
+    return static_cast<double>(a + static_cast<int64_t>(counterRandom(seed, index) % range));
+}
+
+// Домножение элементов [begin, end) и подсчет отрицательных.
+// offset - глобальный индекс arr[0], нужен для четности и генератора
+size_t scaleChunk(double arr[], size_t begin, size_t end, uint64_t offset, int a, int b, uint64_t seed) {
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+        uint64_t global = offset + i;
+        if (global % 2 == 0) {
+            arr[i] *= randomFactor(seed, global, a, b);
+        }
+        count += arr[i] < 0;
+    }
+    return count;
+}
+
+// Копирование отрицательных элементов [begin, end) начиная с out
+void scatterChunk(const double arr[], size_t begin, size_t end, double* out) {
+    for (size_t i = begin; i < end; ++i) {
+        if (arr[i] < 0) {
+            *out++ = arr[i];
+        }
+    }
+}
+
+// Выполнение job(chunk) для всех блоков на threads потоках
+template <typename Job>
+void forEachChunk(size_t chunks, unsigned threads, Job job) {
+    if (threads <= 1 || chunks <= 1) {
+        for (size_t c = 0; c < chunks; ++c) {
+            job(c);
+        }
+        return;
+    }
+
+    threads = static_cast<unsigned>(std::min<size_t>(threads, chunks));
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([=, &job]() {
+            for (size_t c = t; c < chunks; c += threads) {
+                job(c);
+            }
+        });
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+}
+
+// Многопоточная версия processArray с явным seed.
+// Результат побитово совпадает при любом числе потоков.
+// Отрицательные элементы дописываются в nElements в два прохода:
+// сначала подсчет по блокам, затем копирование по готовым смещениям.
+size_t processArrayParallel(double arr[], size_t size, int a, int b, uint64_t seed,
+    std::vector<double>& nElements, unsigned threads = 0, uint64_t offset = 0) {
+    if (b < a) {
+        throw std::invalid_argument("b must not be less than a");
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    size_t chunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<size_t> counts(chunks);
+
+    forEachChunk(chunks, threads, [&](size_t c) {
+        size_t begin = c * CHUNK_SIZE;
+        size_t end = std::min(size, begin + CHUNK_SIZE);
+        counts[c] = scaleChunk(arr, begin, end, offset, a, b, seed);
+    });
+
+    // Префиксные суммы дают позицию каждого блока в результате
+    size_t base = nElements.size();
+    std::vector<size_t> starts(chunks);
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        starts[c] = base + total;
+        total += counts[c];
+    }
+    nElements.resize(base + total);
+
+    forEachChunk(chunks, threads, [&](size_t c) {
+        size_t begin = c * CHUNK_SIZE;
+        size_t end = std::min(size, begin + CHUNK_SIZE);
+        scatterChunk(arr, begin, end, nElements.data() + starts[c]);
+    });
+
+    return total;
+}
+
+// Потоковая обработка: массив читается из in как двоичные double блоками по
+// blockSize элементов, поэтому память под вход не зависит от длины потока.
+// Обработанные значения пишутся в out (если задан), отрицательные - в nElements.
+// Результат совпадает с processArrayParallel над всем массивом с тем же seed.
+size_t processArrayStream(std::istream& in, std::ostream* out, int a, int b, uint64_t seed,
+    std::vector<double>& nElements, size_t blockSize = 1 << 20, unsigned threads = 0) {
+    if (blockSize == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+
+    std::vector<double> block(blockSize);
+    uint64_t offset = 0;
+    size_t total = 0;
+
+    while (in) {
+        in.read(reinterpret_cast<char*>(block.data()), blockSize * sizeof(double));
+        size_t count = static_cast<size_t>(in.gcount()) / sizeof(double);
+        if (count == 0) {
+            break;
+        }
+
+        total += processArrayParallel(block.data(), count, a, b, seed, nElements, threads, offset);
+        if (out != nullptr) {
+            out->write(reinterpret_cast<const char*>(block.data()), count * sizeof(double));
+        }
+        offset += count;
+    }
+
+    return total;
+}
+
+// Ядро "домножить четные и выбрать отрицательные" за один проход.
+// factors[k] - множитель для arr[2k], arr[0] считается четным элементом.
+// В out должно помещаться n + 3 значения: векторные ядра пишут полный регистр.
+typedef size_t (*ScaleCompactKernel)(double* arr, const double* factors, size_t n, double* out);
+
+// Число единичных битов в 4-битной маске
+const int MASK_BITS[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+size_t scaleCompactScalar(double* arr, const double* factors, size_t n, double* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 2 == 0) {
+            arr[i] *= factors[i / 2];
+        }
+        if (arr[i] < 0) {
+            out[count++] = arr[i];
+        }
+    }
+    return count;
+}
+
+#ifdef SIMD_X86
+// Таблица перестановок для сжатия: для маски отрицательных элементов
+// содержит номера 32-битных половин выбранных double, собранных в начало
+struct CompressTable {
+    alignas(32) int32_t perm[16][8];
+
+    CompressTable() {
+        for (int mask = 0; mask < 16; ++mask) {
+            int k = 0;
+            for (int lane = 0; lane < 4; ++lane) {
+                if (mask & (1 << lane)) {
+                    perm[mask][k++] = 2 * lane;
+                    perm[mask][k++] = 2 * lane + 1;
+                }
+            }
+            while (k < 8) {
+                perm[mask][k++] = 0;
+            }
+        }
+    }
+};
+
+const CompressTable COMPRESS_TABLE;
+
+TARGET_AVX2 size_t scaleCompactAvx2(double* arr, const double* factors, size_t n, double* out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d ones = _mm256_set1_pd(1.0);
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        // [f0, f1] -> [f0, f0, f1, f1] -> [f0, 1, f1, 1]
+        __m128d f = _mm_loadu_pd(factors + i / 2);
+        __m256d mul = _mm256_permute4x64_pd(_mm256_castpd128_pd256(f), 0x50);
+        mul = _mm256_blend_pd(mul, ones, 0xA);
+
+        __m256d x = _mm256_mul_pd(_mm256_loadu_pd(arr + i), mul);
+        _mm256_storeu_pd(arr + i, x);
+
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+        __m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i*>(COMPRESS_TABLE.perm[mask]));
+        __m256d packed = _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(x), perm));
+        _mm256_storeu_pd(out + count, packed);
+        count += MASK_BITS[mask];
+    }
+
+    return count + scaleCompactScalar(arr + i, factors + i / 2, n - i, out + count);
+}
+
+TARGET_AVX512 size_t scaleCompactAvx512(double* arr, const double* factors, size_t n, double* out) {
+    const __m512d zero = _mm512_setzero_pd();
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        // Четыре множителя раскладываются в четные позиции, нечетные не трогаются
+        __m512d mul = _mm512_maskz_expandloadu_pd(0x55, factors + i / 2);
+        __m512d x = _mm512_loadu_pd(arr + i);
+        x = _mm512_mask_mul_pd(x, 0x55, x, mul);
+        _mm512_storeu_pd(arr + i, x);
+
+        __mmask8 mask = _mm512_cmp_pd_mask(x, zero, _CMP_LT_OQ);
+        _mm512_mask_compressstoreu_pd(out + count, mask, x);
+        count += MASK_BITS[mask & 0xF] + MASK_BITS[mask >> 4];
+    }
+
+    return count + scaleCompactScalar(arr + i, factors + i / 2, n - i, out + count);
+}
+
+// Проверка поддержки AVX2 / AVX-512F процессором и операционной системой
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    if (!(regs[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuHasAvx512() {
+#if defined(_MSC_VER)
+    if (!cpuHasAvx2() || (_xgetbv(0) & 0xE6) != 0xE6) {
+        return false;
+    }
+    int regs[4];
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 16)) != 0;
+#else
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+#endif
+
+// Выбор ядра по CPUID, выполняется один раз при запуске
+ScaleCompactKernel selectKernel(const char** name = nullptr) {
+    const char* chosen = "scalar";
+    ScaleCompactKernel kernel = scaleCompactScalar;
+#ifdef SIMD_X86
+    if (cpuHasAvx512()) {
+        chosen = "AVX-512";
+        kernel = scaleCompactAvx512;
+    }
+    else if (cpuHasAvx2()) {
+        chosen = "AVX2";
+        kernel = scaleCompactAvx2;
+    }
+#endif
+    if (name != nullptr) {
+        *name = chosen;
+    }
+    return kernel;
+}
+
+const ScaleCompactKernel activeKernel = selectKernel();
+
+// Однопоточная векторная версия processArray с тем же результатом, что и
+// processArrayParallel. Множители генерируются небольшими блоками, чтобы
+// оставаться в кэше L1; под результат выделяется память один раз.
+size_t processArraySimd(double arr[], size_t size, int a, int b, uint64_t seed,
+    std::vector<double>& nElements, ScaleCompactKernel kernel = activeKernel, uint64_t offset = 0) {
+    if (b < a) {
+        throw std::invalid_argument("b must not be less than a");
+    }
+
+    const size_t block = 4096;
+    double factors[block / 2];
+
+    size_t base = nElements.size();
+    nElements.resize(base + size + 4);
+    double* out = nElements.data() + base;
+    size_t total = 0;
+    size_t start = 0;
+
+    // Ядро ожидает, что блок начинается с четного элемента
+    if (size > 0 && offset % 2 != 0) {
+        if (arr[0] < 0) {
+            out[total++] = arr[0];
+        }
+        start = 1;
+    }
+
+    for (; start < size; start += block) {
+        size_t len = std::min(block, size - start);
+        uint64_t global = offset + start;
+        for (size_t k = 0; k < (len + 1) / 2; ++k) {
+            factors[k] = randomFactor(seed, global + 2 * k, a, b);
+        }
+        total += kernel(arr + start, factors, len, out + total);
+    }
+
+    nElements.resize(base + total);
+    return total;
+}
+
+// Замер скорости: исходный цикл, скалярное ядро и выбранное по CPUID
+void runBenchmark(size_t n = 1 << 24, int repeats = 5) {
+    const char* kernelName = nullptr;
+    ScaleCompactKernel best = selectKernel(&kernelName);
+    std::vector<double> arr(n);
+    std::vector<double> nElements;
+    nElements.reserve(n + 4);
+
+    auto measure = [&](const char* title, auto run) {
+        double bestTime = 1e100;
+        for (int r = 0; r < repeats; ++r) {
+            std::fill(arr.begin(), arr.end(), 1.0);
+            nElements.clear();
+            auto begin = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            bestTime = std::min(bestTime, elapsed.count());
+        }
+        std::cout << title << ": " << n / bestTime / 1e6 << " млн эл/с" << std::endl;
+    };
+
+    std::cout << "Элементов: " << n << ", ядро: " << kernelName << std::endl;
+    measure("processArray", [&]() { processArray(arr.data(), static_cast<int>(n), -5, 5, nElements); });
+    measure("scalar", [&]() { processArraySimd(arr.data(), n, -5, 5, 42, nElements, scaleCompactScalar); });
+    measure(kernelName, [&]() { processArraySimd(arr.data(), n, -5, 5, 42, nElements, best); });
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        runBenchmark();
+        return 0;
+    }
+
     std::setlocale(LC_ALL, "Russian"); // Установка локали на русскую
 
     const int n = 15;
@@ -6,26 +6,373 @@
 // 2 задача 
 #include <cmath>   // использования sin и M_PI
 #include <iomanip> // для вывода 
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include <utility>  // для std::index_sequence
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstring>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
 
-void processArray(double* arr1D, double (*arr2D)[5], int size) {
-    int rows = 5, cols = 5;
 
-    // Инициализация одномерного массива по формуле x[n] = n * sin(πn / 25)
-    for (int n = 0; n < size; ++n)
-    {
-        *(arr1D + n) = n * sin(3.14 * n / 25);
+// Синус без ветвлений: приведение аргумента к [-pi/2, pi/2] по Коди-Уэйту
+// и нечетный многочлен Тейлора до x^19. В отличие от std::sin, те же шаги
+// выполняются над четырьмя числами сразу в fillSeriesAvx2.
+constexpr double INV_PI = 0.3183098861837907;
+constexpr double PI_HI = 3.140625;              // k * PI_HI точно при k < 2^45
+constexpr double PI_MID = 0.0009676535846665502; // 27 значащих бит
+constexpr double PI_LO = 5.126688303189038e-12;
+
+// Коэффициенты многочлена по r^2, от старшего: -1/19!, 1/17!, ..., -1/3!
+constexpr size_t SIN_POLY_SIZE = 9;
+constexpr double SIN_POLY[SIN_POLY_SIZE] = {
+    -1.0 / 121645100408832000.0, 1.0 / 355687428096000.0, -1.0 / 1307674368000.0,
+    1.0 / 6227020800.0, -1.0 / 39916800.0, 1.0 / 362880.0, -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0
+};
+
+// sin(x) при известных k = round(x / pi) и sign = (-1)^k
+constexpr double sinReduced(double x, double k, double sign) {
+    double r = ((x - k * PI_HI) - k * PI_MID) - k * PI_LO;
+    double r2 = r * r;
+    double p = SIN_POLY[0];
+    for (size_t i = 1; i < SIN_POLY_SIZE; ++i) {
+        p = p * r2 + SIN_POLY[i];
     }
+    return sign * (r + r * r2 * p);
+}
 
-    // Разложение одномерного массива в двумерный 5x5
-    for (int i = 0; i < rows; ++i) {
+inline double seriesSin(double x) {
+    double k = std::floor(x * INV_PI + 0.5);
+    double half = k * 0.5;
+    double sign = 1.0 - 4.0 * (half - std::floor(half));
+    return sinReduced(x, k, sign);
+}
+
+// То же для вычисления на этапе компиляции (std::floor не constexpr).
+// Аргумент неотрицательный, поэтому отбрасывание дробной части равно floor.
+constexpr double seriesSinConstexpr(double x) {
+    long long k = static_cast<long long>(x * INV_PI + 0.5);
+    return sinReduced(x, static_cast<double>(k), k % 2 == 0 ? 1.0 : -1.0);
+}
+
+// Элемент ряда x[n] = n * sin(pi * n / 25)
+inline double seriesAt(size_t n) {
+    double x = static_cast<double>(n);
+    return x * seriesSin(3.14 * x / 25);
+}
+
+constexpr double seriesAtConstexpr(size_t n) {
+    return static_cast<double>(n) * seriesSinConstexpr(3.14 * static_cast<double>(n) / 25);
+}
+
+// Заполнение out[k] = x[first + k] для k из [0, count).
+// GCC и MSVC не векторизуют этот цикл сами: std::floor при строгой
+// модели вычислений с плавающей точкой остается скалярным вызовом.
+void fillSeriesScalar(double* out, size_t first, size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+        out[k] = seriesAt(first + k);
+    }
+}
+
+typedef void (*FillSeriesKernel)(double* out, size_t first, size_t count);
+
+#ifdef SIMD_X86
+// seriesSin для четырех аргументов: те же операции в том же порядке
+// (без FMA), поэтому результат совпадает со скалярным побитно
+TARGET_AVX2 void fillSeriesAvx2(double* out, size_t first, size_t count) {
+    const __m256d lanes = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    size_t k = 0;
+
+    for (; k + 4 <= count; k += 4) {
+        __m256d x = _mm256_add_pd(_mm256_set1_pd(static_cast<double>(first + k)), lanes);
+        __m256d arg = _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(3.14), x), _mm256_set1_pd(25.0));
+
+        __m256d n = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(arg, _mm256_set1_pd(INV_PI)), half));
+        __m256d h = _mm256_mul_pd(n, half);
+        __m256d sign = _mm256_sub_pd(one, _mm256_mul_pd(four, _mm256_sub_pd(h, _mm256_floor_pd(h))));
+
+        __m256d r = _mm256_sub_pd(arg, _mm256_mul_pd(n, _mm256_set1_pd(PI_HI)));
+        r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(PI_MID)));
+        r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(PI_LO)));
+        __m256d r2 = _mm256_mul_pd(r, r);
+        __m256d p = _mm256_set1_pd(SIN_POLY[0]);
+        for (size_t i = 1; i < SIN_POLY_SIZE; ++i) {
+            p = _mm256_add_pd(_mm256_mul_pd(p, r2), _mm256_set1_pd(SIN_POLY[i]));
+        }
+        __m256d sine = _mm256_mul_pd(sign, _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, r2), p)));
+        _mm256_storeu_pd(out + k, _mm256_mul_pd(x, sine));
+    }
+
+    fillSeriesScalar(out + k, first + k, count - k);
+}
+
+// Проверка поддержки AVX2 процессором и операционной системой
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    if (!(regs[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// Выбор ядра по CPUID, выполняется один раз при запуске
+FillSeriesKernel selectFillSeries() {
+#ifdef SIMD_X86
+    if (cpuHasAvx2()) {
+        return fillSeriesAvx2;
+    }
+#endif
+    return fillSeriesScalar;
+}
+
+const FillSeriesKernel activeFillSeries = selectFillSeries();
+
+void fillSeries(double* out, size_t first, size_t count) {
+    activeFillSeries(out, first, count);
+}
+
+// Разложение строк [rowBegin, rowEnd): элементы 1..cols-1 копируются из ряда,
+// в нулевой столбец записывается их сумма
+void reduceRows(const double* arr1D, double* matrix, size_t rowBegin, size_t rowEnd, size_t cols) {
+    for (size_t i = rowBegin; i < rowEnd; ++i) {
+        const double* src = arr1D + i * cols;
+        double* row = matrix + i * cols;
         double sum = 0;
-        for (int j = 1; j < cols; ++j) {
-            *(*(arr2D + i) + j) = *(arr1D + i * cols + j);
-            sum += *(*(arr2D + i) + j);
+        for (size_t j = 1; j < cols; ++j) {
+            row[j] = src[j];
+            sum += src[j];
         }
-        *(*(arr2D + i) + 0) = sum;
+        row[0] = sum;
+    }
+}
+
+// Обобщенное преобразование для матрицы rows x cols, хранящейся построчно в
+// одном непрерывном блоке. Если arr1D == nullptr, ряд считается прямо в matrix.
+// Строки делятся между потоками; каждый поток сам заполняет свою часть ряда,
+// поэтому данные не покидают кэш ядра между заполнением и суммированием.
+void processMatrix(double* arr1D, double* matrix, size_t rows, size_t cols, unsigned threads = 0) {
+    if (cols == 0) {
+        throw std::invalid_argument("Matrix must have at least one column");
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    double* series = arr1D != nullptr ? arr1D : matrix;
+
+    // Мелкие матрицы не стоят запуска потоков
+    const size_t minRowsPerThread = (1 << 14) / cols + 1;
+    threads = static_cast<unsigned>(std::min<size_t>(threads, rows / minRowsPerThread + 1));
+
+    auto work = [=](size_t rowBegin, size_t rowEnd) {
+        fillSeries(series + rowBegin * cols, rowBegin * cols, (rowEnd - rowBegin) * cols);
+        reduceRows(series, matrix, rowBegin, rowEnd, cols);
+    };
+
+    if (threads <= 1) {
+        work(0, rows);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    size_t step = (rows + threads - 1) / threads;
+    for (size_t begin = 0; begin < rows; begin += step) {
+        pool.emplace_back(work, begin, std::min(rows, begin + step));
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+}
+
+// Исходный интерфейс для матрицы с 5 столбцами: ряд заполняется на всю
+// длину size, в матрицу раскладываются только полные строки
+void processArray(double* arr1D, double (*arr2D)[5], int size) {
+    const size_t cols = 5;
+    const size_t count = static_cast<size_t>(std::max(size, 0));
+    fillSeries(arr1D, 0, count);
+    reduceRows(arr1D, &arr2D[0][0], 0, count / cols, cols);
+}
+
+// Вариант для размеров, известных на этапе компиляции: циклы полностью
+// разворачиваются раскрытием пакетов индексов
+template <size_t... J>
+inline double rowSum(const double* src, double* row, std::index_sequence<J...>) {
+    double sum = 0;
+    int unroll[] = { 0, (row[J + 1] = src[J + 1], sum += src[J + 1], 0)... };
+    (void)unroll;
+    return sum;
+}
+
+template <size_t... N>
+inline void fillSeriesUnrolled(double* out, std::index_sequence<N...>) {
+    int unroll[] = { 0, (out[N] = seriesAt(N), 0)... };
+    (void)unroll;
+}
+
+template <size_t Cols, size_t... I>
+inline void reduceRowsUnrolled(const double* arr1D, double (*arr2D)[Cols], std::index_sequence<I...>) {
+    int unroll[] = { 0, (arr2D[I][0] = rowSum(arr1D + I * Cols, arr2D[I], std::make_index_sequence<Cols - 1>()), 0)... };
+    (void)unroll;
+}
+
+template <size_t Rows, size_t Cols>
+void processArray(double* arr1D, double (*arr2D)[Cols]) {
+    static_assert(Cols > 0, "Matrix must have at least one column");
+    fillSeriesUnrolled(arr1D, std::make_index_sequence<Rows * Cols>());
+    reduceRowsUnrolled<Cols>(arr1D, arr2D, std::make_index_sequence<Rows>());
+}
+
+// Неизменяемый участок ряда без копирования данных
+struct SeriesSpan {
+    const double* data;
+    size_t size;
+
+    const double* begin() const { return data; }
+    const double* end() const { return data + size; }
+    double operator[](size_t i) const { return data[i]; }
+};
+
+// Первые элементы ряда, вычисленные на этапе компиляции
+template <size_t N>
+struct StaticSeries {
+    double values[N];
+
+    constexpr StaticSeries() : values() {
+        for (size_t n = 0; n < N; ++n) {
+            values[n] = seriesAtConstexpr(n);
+        }
+    }
+};
+
+// Кэш ряда x[n] = n * sin(pi * n / 25), общий для всех запросов.
+// Короткие префиксы отдаются из таблицы, построенной при компиляции,
+// длинные - из буфера, который лениво дозаполняется блоками.
+// Чтение идет без блокировок: при нехватке емкости создается новый буфер,
+// а старые не освобождаются до уничтожения кэша, поэтому выданные ранее
+// SeriesSpan остаются корректными. Рост выполняется под мьютексом.
+class SeriesCache {
+public:
+    static constexpr size_t STATIC_SIZE = 256;
+    static constexpr size_t BLOCK_SIZE = 1 << 14;
+
+    SeriesCache() : buffer(nullptr), size(0) {}
+
+    SeriesCache(const SeriesCache&) = delete;
+    SeriesCache& operator=(const SeriesCache&) = delete;
+
+    // Префикс ряда длины count
+    SeriesSpan prefix(size_t count) {
+        if (count <= STATIC_SIZE) {
+            return SeriesSpan{ staticSeries.values, count };
+        }
+
+        // size публикуется после buffer, поэтому buffer вмещает не меньше size
+        if (count > size.load(std::memory_order_acquire)) {
+            extend(count);
+        }
+        return SeriesSpan{ buffer.load(std::memory_order_acquire), count };
+    }
+
+    // Участок ряда [first, first + count)
+    SeriesSpan slice(size_t first, size_t count) {
+        SeriesSpan all = prefix(first + count);
+        return SeriesSpan{ all.data + first, count };
+    }
+
+    size_t cachedSize() const {
+        return std::max(STATIC_SIZE, size.load(std::memory_order_acquire));
+    }
+
+private:
+    static constexpr StaticSeries<STATIC_SIZE> staticSeries = StaticSeries<STATIC_SIZE>();
+
+    std::atomic<double*> buffer;
+    std::atomic<size_t> size;
+    size_t capacity = 0;
+    std::vector<std::unique_ptr<double[]>> generations;
+    std::mutex growMutex;
+
+    void extend(size_t count) {
+        std::lock_guard<std::mutex> lock(growMutex);
+        size_t filled = size.load(std::memory_order_relaxed);
+        if (count <= filled) {
+            return; // Другой поток уже дозаполнил
+        }
+
+        size_t target = (count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+        double* data = buffer.load(std::memory_order_relaxed);
+
+        if (target > capacity) {
+            size_t newCapacity = std::max(target, capacity * 2);
+            std::unique_ptr<double[]> next(new double[newCapacity]);
+            if (filled > 0) {
+                std::memcpy(next.get(), data, filled * sizeof(double));
+            }
+            else {
+                std::memcpy(next.get(), staticSeries.values, STATIC_SIZE * sizeof(double));
+                filled = STATIC_SIZE;
+            }
+            fillSeries(next.get() + filled, filled, target - filled);
+
+            data = next.get();
+            generations.push_back(std::move(next));
+            capacity = newCapacity;
+            buffer.store(data, std::memory_order_release);
+        }
+        else {
+            // Читатели видят только [0, size), поэтому хвост можно писать на месте
+            fillSeries(data + filled, filled, target - filled);
+        }
+
+        size.store(target, std::memory_order_release);
+    }
+};
+
+constexpr size_t SeriesCache::STATIC_SIZE;
+constexpr size_t SeriesCache::BLOCK_SIZE;
+constexpr StaticSeries<SeriesCache::STATIC_SIZE> SeriesCache::staticSeries;
+
+// Общий кэш процесса
+SeriesCache& seriesCache() {
+    static SeriesCache cache;
+    return cache;
+}
+
+// Преобразование матрицы rows x cols с рядом из кэша вместо пересчета
+void processMatrixCached(double* matrix, size_t rows, size_t cols, SeriesCache& cache = seriesCache()) {
+    if (cols == 0) {
+        throw std::invalid_argument("Matrix must have at least one column");
     }
+    SeriesSpan series = cache.prefix(rows * cols);
+    reduceRows(series.data, matrix, 0, rows, cols);
 }
 
 int main() {
@@ -37,7 +384,7 @@ int main() {
     double arr1D[rows * cols];
     double arr2D[rows][cols];
 
-    processArray(arr1D, arr2D, rows * cols);
+    processArray<rows, cols>(arr1D, arr2D);
 
     // Вывод двумерного массива с шириной каждого элемента 10 позиций
     cout << std::fixed << std::setprecision(4);
@@ -3,8 +3,39 @@
 #include <cstdlib>  // для rand() и srand()
 #include <ctime>  // для time()
 #include <locale>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <iomanip>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
 
-char* my_strchr(char* s, int c) {
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Исходная побайтовая версия, оставлена для сравнения в замерах
+char* my_strchr_scalar(char* s, int c) {
 
     while (*s != '\0') {
         if (*s == (char)(c)) {
@@ -15,8 +46,757 @@ char* my_strchr(char* s, int c) {
     return nullptr;
 }
 
-int main()
+const char* memchrScalar(const char* s, char c, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (s[i] == c) {
+            return s + i;
+        }
+    }
+    return nullptr;
+}
+
+#ifdef SIMD_X86
+// Номер младшего единичного бита ненулевой маски
+inline unsigned lowestBit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Поиск первого байта, равного c или '\0', блоками по 16 байт.
+// Начало выравнивается вниз до 16 байт: выровненное чтение не пересекает
+// границу страницы, а биты байтов до s отбрасываются маской.
+const char* strchrSse2(const char* s, char c) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i needle = _mm_set1_epi8(c);
+
+    size_t offset = reinterpret_cast<uintptr_t>(s) & 15;
+    const __m128i* p = reinterpret_cast<const __m128i*>(s - offset);
+
+    __m128i chunk = _mm_load_si128(p);
+    uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, zero), _mm_cmpeq_epi8(chunk, needle)));
+    mask &= ~0u << offset;
+
+    while (mask == 0) {
+        chunk = _mm_load_si128(++p);
+        mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, zero), _mm_cmpeq_epi8(chunk, needle)));
+    }
+
+    return reinterpret_cast<const char*>(p) + lowestBit(mask);
+}
+
+TARGET_AVX2 const char* strchrAvx2(const char* s, char c) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i needle = _mm256_set1_epi8(c);
+
+    size_t offset = reinterpret_cast<uintptr_t>(s) & 31;
+    const __m256i* p = reinterpret_cast<const __m256i*>(s - offset);
+
+    __m256i chunk = _mm256_load_si256(p);
+    uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, zero), _mm256_cmpeq_epi8(chunk, needle)));
+    mask &= ~0u << offset;
+
+    while (mask == 0) {
+        chunk = _mm256_load_si256(++p);
+        mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, zero), _mm256_cmpeq_epi8(chunk, needle)));
+    }
+
+    return reinterpret_cast<const char*>(p) + lowestBit(mask);
+}
+
+// Для ограниченного буфера невыровненные чтения не выходят за [s, s + n)
+const char* memchrSse2(const char* s, char c, size_t n) {
+    const __m128i needle = _mm_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return s + i + lowestBit(mask);
+        }
+    }
+    return memchrScalar(s + i, c, n - i);
+}
+
+TARGET_AVX2 const char* memchrAvx2(const char* s, char c, size_t n) {
+    const __m256i needle = _mm256_set1_epi8(c);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return s + i + lowestBit(mask);
+        }
+    }
+    // Хвост короче 32 байт: 16-байтный шаг внутри той же функции, чтобы не
+    // переходить в SSE-код с грязными верхними половинами регистров
+    if (i + 16 <= n) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm256_castsi256_si128(needle)));
+        if (mask != 0) {
+            return s + i + lowestBit(mask);
+        }
+        i += 16;
+    }
+    return memchrScalar(s + i, c, n - i);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    if (!(regs[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// Реализации выбираются один раз при запуске
+typedef const char* (*StrchrImpl)(const char* s, char c);
+typedef const char* (*MemchrImpl)(const char* s, char c, size_t n);
+
+StrchrImpl selectStrchr() {
+#ifdef SIMD_X86
+    return cpuHasAvx2() ? strchrAvx2 : strchrSse2;
+#else
+    return [](const char* s, char c) -> const char* {
+        return my_strchr_scalar(const_cast<char*>(s), c);
+    };
+#endif
+}
+
+MemchrImpl selectMemchr() {
+#ifdef SIMD_X86
+    return cpuHasAvx2() ? memchrAvx2 : memchrSse2;
+#else
+    return memchrScalar;
+#endif
+}
+
+const StrchrImpl strchrImpl = selectStrchr();
+const MemchrImpl memchrImpl = selectMemchr();
+
+// Первое вхождение c в строку s или nullptr; '\0' не ищется
+char* my_strchr(char* s, int c) {
+    const char* hit = strchrImpl(s, static_cast<char>(c));
+    if (*hit == '\0') {
+        return nullptr;
+    }
+    return const_cast<char*>(hit);
+}
+
+// Первое вхождение c среди первых n байт s или nullptr
+char* my_memchr(char* s, int c, size_t n) {
+    return const_cast<char*>(memchrImpl(s, static_cast<char>(c), n));
+}
+
+// Кодирование code point в UTF-8; 0 для суррогатов и значений вне Unicode
+size_t encodeUtf8(char32_t cp, char out[4]) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp >= 0xD800 && cp <= 0xDFFF) {
+        return 0;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    if (cp < 0x110000) {
+        out[0] = static_cast<char>(0xF0 | (cp >> 18));
+        out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+    return 0;
+}
+
+// Длина корректной последовательности в начале p (доступно n байт) или 0.
+// Отвергаются лишние байты продолжения, обрезанные и избыточные
+// последовательности, суррогаты и значения больше U+10FFFF.
+size_t utf8SequenceLength(const unsigned char* p, size_t n) {
+    unsigned char b = p[0];
+    if (b < 0x80) {
+        return 1;
+    }
+    if (b < 0xC2) {
+        return 0;
+    }
+
+    size_t len = b < 0xE0 ? 2 : b < 0xF0 ? 3 : b < 0xF5 ? 4 : 0;
+    if (len == 0 || n < len) {
+        return 0;
+    }
+    for (size_t i = 1; i < len; ++i) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+
+    if ((b == 0xE0 && p[1] < 0xA0) || (b == 0xED && p[1] >= 0xA0) ||
+        (b == 0xF0 && p[1] < 0x90) || (b == 0xF4 && p[1] >= 0x90)) {
+        return 0;
+    }
+    return len;
+}
+
+// Начало первой некорректной последовательности в [s, s + n) или nullptr.
+// ASCII-участки пропускаются блоками по 16 байт, двухбайтовые символы
+// (кириллица) проверяются без полного разбора.
+const char* findMalformedUtf8(const char* s, size_t n) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    size_t i = 0;
+    while (i < n) {
+        unsigned char b = p[i];
+        if (b < 0x80) {
+#ifdef SIMD_X86
+            while (i + 16 <= n && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))) == 0) {
+                i += 16;
+            }
+            while (i < n && p[i] < 0x80) {
+                ++i;
+            }
+#else
+            ++i;
+#endif
+            continue;
+        }
+        if (b >= 0xC2 && b < 0xE0 && i + 1 < n && (p[i + 1] & 0xC0) == 0x80) {
+            i += 2;
+            continue;
+        }
+        size_t len = utf8SequenceLength(p + i, n - i);
+        if (len == 0) {
+            return s + i;
+        }
+        i += len;
+    }
+    return nullptr;
+}
+
+// Поиск пары байтов (lead, next) или '\0' для многобайтовых символов.
+// Для кириллицы один ведущий байт 0xD0/0xD1 встречается почти в каждом
+// символе, поэтому кандидатом считается только совпадение двух байтов подряд.
+// Ведущий байт в последней позиции блока возвращается как кандидат без
+// проверки следующего байта: вызывающий код все равно сверяет продолжение.
+const char* strchrPairScalar(const char* s, char lead, char next) {
+    for (;; ++s) {
+        if (*s == '\0' || (*s == lead && s[1] == next)) {
+            return s;
+        }
+    }
+}
+
+#ifdef SIMD_X86
+const char* strchrPairSse2(const char* s, char lead, char next) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i leadVec = _mm_set1_epi8(lead);
+    const __m128i nextVec = _mm_set1_epi8(next);
+
+    size_t offset = reinterpret_cast<uintptr_t>(s) & 15;
+    const __m128i* p = reinterpret_cast<const __m128i*>(s - offset);
+    uint32_t skip = ~0u << offset;
+
+    for (;; ++p, skip = ~0u) {
+        __m128i chunk = _mm_load_si128(p);
+        uint32_t leads = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, leadVec));
+        uint32_t nexts = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nextVec));
+        uint32_t zeros = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+        uint32_t mask = ((leads & ((nexts >> 1) | 0x8000)) | zeros) & skip;
+        if (mask != 0) {
+            return reinterpret_cast<const char*>(p) + lowestBit(mask);
+        }
+    }
+}
+
+TARGET_AVX2 const char* strchrPairAvx2(const char* s, char lead, char next) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i leadVec = _mm256_set1_epi8(lead);
+    const __m256i nextVec = _mm256_set1_epi8(next);
+
+    size_t offset = reinterpret_cast<uintptr_t>(s) & 31;
+    const __m256i* p = reinterpret_cast<const __m256i*>(s - offset);
+    uint32_t skip = ~0u << offset;
+
+    for (;; ++p, skip = ~0u) {
+        __m256i chunk = _mm256_load_si256(p);
+        uint32_t leads = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, leadVec));
+        uint32_t nexts = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nextVec));
+        uint32_t zeros = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, zero));
+        uint32_t mask = ((leads & ((nexts >> 1) | 0x80000000u)) | zeros) & skip;
+        if (mask != 0) {
+            return reinterpret_cast<const char*>(p) + lowestBit(mask);
+        }
+    }
+}
+#endif
+
+typedef const char* (*StrchrPairImpl)(const char* s, char lead, char next);
+
+StrchrPairImpl selectStrchrPair() {
+#ifdef SIMD_X86
+    return cpuHasAvx2() ? strchrPairAvx2 : strchrPairSse2;
+#else
+    return strchrPairScalar;
+#endif
+}
+
+const StrchrPairImpl strchrPairImpl = selectStrchrPair();
+
+// Первое вхождение code point cp в UTF-8 строку s или nullptr.
+// Векторно ищется ведущий байт вместе с первым байтом продолжения, остальные
+// байты проверяются только на найденных кандидатах. В корректном UTF-8
+// ведущий байт не встречается внутри другой последовательности, поэтому
+// ложных совпадений нет.
+char* my_strchr_utf8(char* s, char32_t cp) {
+    char seq[4];
+    size_t len = encodeUtf8(cp, seq);
+    if (len == 0) {
+        throw std::invalid_argument("Invalid Unicode code point");
+    }
+    if (len == 1) {
+        return my_strchr(s, seq[0]);
+    }
+
+    const char* p = s;
+    for (;;) {
+        const char* hit = strchrPairImpl(p, seq[0], seq[1]);
+        if (*hit == '\0') {
+            return nullptr;
+        }
+        // Сравнение обрывается на первом несовпадении, в том числе на '\0',
+        // поэтому не читает за концом строки
+        size_t k = 1;
+        while (k < len && hit[k] == seq[k]) {
+            ++k;
+        }
+        if (k == len) {
+            return const_cast<char*>(hit);
+        }
+        p = hit + 1;
+    }
+}
+
+// Результат поиска с проверкой: position - найденный символ, malformed -
+// первая некорректная последовательность до него (тогда position == nullptr)
+struct Utf8Match {
+    char* position;
+    char* malformed;
+};
+
+// Поиск с проверкой корректности текста от начала строки до найденного
+// символа включительно (или до конца строки, если символ не найден)
+Utf8Match my_strchr_utf8_checked(char* s, char32_t cp) {
+    char* hit = my_strchr_utf8(s, cp);
+    char seq[4];
+    const char* limit = hit != nullptr ? hit + encodeUtf8(cp, seq) : strchrImpl(s, '\0');
+
+    const char* bad = findMalformedUtf8(s, static_cast<size_t>(limit - s));
+    if (bad != nullptr) {
+        return Utf8Match{ nullptr, const_cast<char*>(bad) };
+    }
+    return Utf8Match{ hit, nullptr };
+}
+
+// Наивный поиск с декодированием каждого символа, для сравнения в замерах
+const char* strchrUtf8Naive(const char* s, char32_t cp) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    while (*p != 0) {
+        char32_t value;
+        size_t len;
+        if (*p < 0x80) { value = *p; len = 1; }
+        else if (*p < 0xE0) { value = *p & 0x1F; len = 2; }
+        else if (*p < 0xF0) { value = *p & 0x0F; len = 3; }
+        else { value = *p & 0x07; len = 4; }
+        size_t k = 1;
+        for (; k < len && p[k] != 0; ++k) {
+            value = (value << 6) | (p[k] & 0x3F);
+        }
+        if (k == len && value == cp) {
+            return reinterpret_cast<const char*>(p);
+        }
+        p += k;
+    }
+    return nullptr;
+}
+
+// Сравнение с std::strchr/std::memchr на строках разной длины.
+// Искомый символ стоит в конце строки, чтобы просматривалась она целиком.
+void runBenchmark() {
+    const size_t lengths[] = { 16, 64, 256, 1024, 4096, 16384, 65536 };
+    const size_t totalBytes = size_t(1) << 28;
+
+    std::cout << "Скорость, ГБ/с" << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+        << std::setw(6) << "Bytes" << std::setw(12) << "scalar" << std::setw(12) << "my_strchr"
+        << std::setw(12) << "strchr" << std::setw(12) << "my_memchr" << std::setw(12) << "memchr" << std::endl;
+    for (size_t len : lengths) {
+        // Смещение на 3 байта проверяет невыровненное начало
+        std::string storage(len + 3 + 1, 'a');
+        char* str = &storage[3];
+        str[len - 1] = 'W';
+        str[len] = '\0';
+        size_t repeats = totalBytes / len;
+
+        auto measure = [&](auto find) {
+            char* volatile target = str; // не дает вынести вызов из цикла
+            uintptr_t sink = 0;
+            auto begin = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < repeats; ++r) {
+                sink += reinterpret_cast<uintptr_t>(find(target));
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            if (sink == 0) {
+                std::cout << "Символ не найден" << std::endl;
+            }
+            return static_cast<double>(len) * repeats / elapsed.count() / 1e9;
+        };
+
+        std::cout << std::setw(6) << len
+            << std::setw(12) << measure([](char* p) { return my_strchr_scalar(p, 'W'); })
+            << std::setw(12) << measure([](char* p) { return my_strchr(p, 'W'); })
+            << std::setw(12) << measure([](char* p) { return std::strchr(p, 'W'); })
+            << std::setw(12) << measure([len](char* p) { return my_memchr(p, 'W', len); })
+            << std::setw(12) << measure([len](char* p) { return static_cast<char*>(std::memchr(p, 'W', len)); })
+            << std::endl;
+    }
+}
+
+// Замер поиска U+044F 'я' в конце текста: латиница, смесь и кириллица
+void runUtf8Benchmark() {
+    const char* latin = u8"lorem ipsum dolor sit amet ";
+    const char* cyrillic = u8"съешь же ещё этих французских булок да выпей чаю ";
+    const size_t length = 1 << 16;
+    const size_t totalBytes = size_t(1) << 28;
+
+    struct Corpus {
+        const char* name;
+        std::string text;
+    } corpora[] = { { "latin", "" }, { "mixed", "" }, { "cyrillic", "" } };
+
+    for (int i = 0; corpora[0].text.size() < length; ++i) {
+        corpora[0].text += latin;
+        corpora[1].text += i % 2 == 0 ? latin : cyrillic;
+        corpora[2].text += cyrillic;
+    }
+
+    std::cout << "Скорость, ГБ/с" << std::endl;
+    std::cout << std::fixed << std::setprecision(2) << std::setw(10) << "Corpus"
+        << std::setw(12) << "naive" << std::setw(12) << "utf8" << std::setw(12) << "checked" << std::endl;
+
+    for (Corpus& corpus : corpora) {
+        // Текст собран из целых фраз, поэтому обрезанных последовательностей нет
+        std::string text = corpus.text + u8"я";
+        char* str = &text[0];
+        size_t repeats = totalBytes / text.size();
+
+        auto measure = [&](auto find) {
+            char* volatile target = str;
+            uintptr_t sink = 0;
+            auto begin = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < repeats; ++r) {
+                sink += reinterpret_cast<uintptr_t>(find(target));
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            if (sink == 0) {
+                std::cout << "Символ не найден" << std::endl;
+            }
+            return static_cast<double>(text.size()) * repeats / elapsed.count() / 1e9;
+        };
+
+        double naive = measure([](char* p) { return strchrUtf8Naive(p, U'\u044F'); });
+        double utf8 = measure([](char* p) { return my_strchr_utf8(p, U'\u044F'); });
+        double checked = measure([](char* p) { return my_strchr_utf8_checked(p, U'\u044F').position; });
+        std::cout << std::setw(10) << corpus.name << std::setw(12) << naive
+            << std::setw(12) << utf8 << std::setw(12) << checked << std::endl;
+    }
+}
+
+// Файл, отображенный в память только для чтения
+class MappedFile {
+private:
+    const char* data;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) : data(nullptr), size(0) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(file, &length)) {
+            CloseHandle(file);
+            throw std::runtime_error("Cannot read file size: " + path);
+        }
+        size = static_cast<size_t>(length.QuadPart);
+        mapping = nullptr;
+        if (size > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            data = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (data == nullptr) {
+                if (mapping) CloseHandle(mapping);
+                CloseHandle(file);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+        }
+#else
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot read file size: " + path);
+        }
+        size = static_cast<size_t>(info.st_size);
+        if (size > 0) {
+            void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+            madvise(view, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(view);
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        if (data) munmap(const_cast<char*>(data), size);
+        close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+// Набор искомых символов в виде двух таблиц по полубайтам: байт b входит в
+// набор, если lo[b & 15] & hi[b >> 4] != 0. Символы с одинаковым старшим
+// полубайтом делят один бит, поэтому набор точен, пока различных старших
+// полубайтов не больше восьми (любые ASCII-разделители и кавычки).
+class CharSet {
+private:
+    uint8_t lo[16];
+    uint8_t hi[16];
+    std::string chars;
+
+public:
+    explicit CharSet(const std::string& set) : lo(), hi(), chars() {
+        int bitOf[16];
+        std::fill(bitOf, bitOf + 16, -1);
+        int nextBit = 0;
+
+        for (char ch : set) {
+            unsigned char b = static_cast<unsigned char>(ch);
+            if (chars.find(ch) != std::string::npos) {
+                continue;
+            }
+            chars += ch;
+
+            int high = b >> 4;
+            if (bitOf[high] < 0) {
+                if (nextBit == 8) {
+                    throw std::invalid_argument("Character set spans more than 8 high nibbles");
+                }
+                bitOf[high] = nextBit++;
+            }
+            uint8_t bit = static_cast<uint8_t>(1u << bitOf[high]);
+            hi[high] |= bit;
+            lo[b & 15] |= bit;
+        }
+    }
+
+    bool contains(unsigned char b) const {
+        return (lo[b & 15] & hi[b >> 4]) != 0;
+    }
+
+    const uint8_t* getLo() const { return lo; }
+    const uint8_t* getHi() const { return hi; }
+    const std::string& getChars() const { return chars; }
+};
+
+// Позиции всех символов набора в [begin, end) относительно data
+void scanScalar(const char* data, size_t begin, size_t end, const CharSet& set, std::vector<uint64_t>& out) {
+    for (size_t i = begin; i < end; ++i) {
+        if (set.contains(static_cast<unsigned char>(data[i]))) {
+            out.push_back(i);
+        }
+    }
+}
+
+#ifdef SIMD_X86
+// Классификация 32 байт за итерацию двумя pshufb по полубайтам
+TARGET_AVX2 void scanAvx2(const char* data, size_t begin, size_t end, const CharSet& set, std::vector<uint64_t>& out) {
+    const __m256i loTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.getLo())));
+    const __m256i hiTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.getHi())));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = begin;
+    for (; i + 32 <= end; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i loClass = _mm256_shuffle_epi8(loTable, _mm256_and_si256(chunk, nibble));
+        __m256i hiClass = _mm256_shuffle_epi8(hiTable, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble));
+        __m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(loClass, hiClass), zero);
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(miss));
+
+        while (mask != 0) {
+            out.push_back(i + lowestBit(mask));
+            mask &= mask - 1;
+        }
+    }
+    scanScalar(data, i, end, set, out);
+}
+#endif
+
+// Один символ ищется через my_memchr
+void scanSingle(const char* data, size_t begin, size_t end, char c, std::vector<uint64_t>& out) {
+    const char* p = data + begin;
+    const char* last = data + end;
+    while (p < last) {
+        const char* hit = memchrImpl(p, c, static_cast<size_t>(last - p));
+        if (hit == nullptr) {
+            break;
+        }
+        out.push_back(static_cast<uint64_t>(hit - data));
+        p = hit + 1;
+    }
+}
+
+typedef void (*ScanImpl)(const char* data, size_t begin, size_t end, const CharSet& set, std::vector<uint64_t>& out);
+
+ScanImpl selectScan() {
+#ifdef SIMD_X86
+    if (cpuHasAvx2()) {
+        return scanAvx2;
+    }
+#endif
+    return scanScalar;
+}
+
+const ScanImpl scanImpl = selectScan();
+
+// Смещения всех вхождений символов набора в буфер, по возрастанию.
+// Буфер делится на участки по числу потоков, границы выровнены на 64 байта.
+// Символы однобайтовые, поэтому каждое вхождение попадает ровно в один участок;
+// результаты участков склеиваются по префиксным суммам их длин.
+std::vector<uint64_t> scanAll(const char* data, size_t size, const CharSet& set, unsigned threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t minChunk = size_t(1) << 20;
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, size / minChunk)));
+
+    size_t step = (size / threads + 63) & ~size_t(63);
+    std::vector<std::vector<uint64_t>> parts(threads);
+
+    auto work = [&](unsigned t) {
+        size_t begin = std::min(size, t * step);
+        size_t end = (t + 1 == threads) ? size : std::min(size, begin + step);
+        if (set.getChars().size() == 1) {
+            scanSingle(data, begin, end, set.getChars()[0], parts[t]);
+        }
+        else {
+            scanImpl(data, begin, end, set, parts[t]);
+        }
+    };
+
+    if (threads == 1) {
+        work(0);
+        return std::move(parts[0]);
+    }
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back(work, t);
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    std::vector<uint64_t> offsets(total);
+    size_t pos = 0;
+    for (const auto& part : parts) {
+        std::copy(part.begin(), part.end(), offsets.begin() + pos);
+        pos += part.size();
+    }
+    return offsets;
+}
+
+// Смещения всех символов из chars в файле path
+std::vector<uint64_t> scanFile(const std::string& path, const std::string& chars, unsigned threads = 0) {
+    CharSet set(chars);
+    MappedFile file(path);
+    return scanAll(file.getData(), file.getSize(), set, threads);
+}
+
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        runBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-utf8") == 0) {
+        runUtf8Benchmark();
+        return 0;
+    }
+    if (argc > 3 && std::strcmp(argv[1], "--scan") == 0) {
+        try {
+            std::vector<uint64_t> offsets = scanFile(argv[2], argv[3]);
+            std::cout << "Найдено: " << offsets.size() << std::endl;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     std::setlocale(LC_ALL, "Russian"); // Установка локали на русскую
     char str[] = "Hello, World!";
     char ch = 'W';
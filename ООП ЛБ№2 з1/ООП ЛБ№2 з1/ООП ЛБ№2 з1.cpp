@@ -1,36 +1,294 @@
 ﻿#include <iostream>
 #include <iomanip>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <new>
+#include <thread>
+#include <vector>
+#include <type_traits>
+#include <utility>
+#include <string>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Выравнивание буферов по строке кэша
+const size_t CACHE_LINE = 64;
+
+// Выделение count элементов типа T, выровненных по CACHE_LINE.
+// Перед выровненным блоком хранится указатель, полученный от malloc.
+template <typename T>
+T* allocateAligned(size_t count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    if (count > (SIZE_MAX - CACHE_LINE - sizeof(void*)) / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+    void* raw = std::malloc(count * sizeof(T) + CACHE_LINE + sizeof(void*));
+    if (raw == nullptr) {
+        throw std::bad_alloc();
+    }
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<T*>(aligned);
+}
+
+void freeAligned(void* data) {
+    if (data != nullptr) {
+        std::free(static_cast<void**>(data)[-1]);
+    }
+}
+
+// Выражения над Vector и Matrix (expression templates).
+// Цепочка вида m + 1 - other * 2 строит дерево объектов без вычислений,
+// а при присваивании все элементы считаются за один проход без временных
+// массивов. Листья хранят указатель на данные, поэтому выражение нельзя
+// сохранять дольше, чем живут участвующие в нем объекты.
+
+// Размер результата выражения; у скаляра {0, 0}, он подходит к любому размеру
+struct Shape {
+    size_t rows;
+    size_t cols;
+
+    bool isScalar() const {
+        return rows == 0 && cols == 0;
+    }
+};
+
+inline Shape combineShapes(Shape a, Shape b) {
+    if (a.isScalar()) {
+        return b;
+    }
+    if (!b.isScalar() && (a.rows != b.rows || a.cols != b.cols)) {
+        throw std::invalid_argument("Size mismatch in expression");
+    }
+    return a;
+}
+
+// Базовый класс узлов выражения
+template <typename E>
+struct Expr {
+    const E& self() const {
+        return static_cast<const E&>(*this);
+    }
+};
+
+// Лист: элементы Vector или Matrix
+template <typename T>
+class DataExpr : public Expr<DataExpr<T>> {
+private:
+    const T* data;
+    Shape sh;
+
+public:
+    typedef T value_type;
+
+    DataExpr(const T* data, Shape sh) : data(data), sh(sh) {}
+
+    T operator[](size_t k) const { return data[k]; }
+    Shape shape() const { return sh; }
+};
+
+// Лист: скаляр, одинаковый для всех элементов
+template <typename T>
+class ScalarExpr : public Expr<ScalarExpr<T>> {
+private:
+    T value;
+
+public:
+    typedef T value_type;
+
+    explicit ScalarExpr(T value) : value(value) {}
+
+    T operator[](size_t) const { return value; }
+    Shape shape() const { return Shape{ 0, 0 }; }
+};
+
+struct AddOp {
+    template <typename V> static V apply(V a, V b) { return a + b; }
+};
+
+struct SubOp {
+    template <typename V> static V apply(V a, V b) { return a - b; }
+};
+
+struct MulOp {
+    template <typename V> static V apply(V a, V b) { return a * b; }
+};
+
+struct DivOp {
+    template <typename V> static V apply(V a, V b) { return a / b; }
+};
+
+// Узел: поэлементная операция над двумя подвыражениями
+template <typename L, typename R, typename Op>
+class BinaryExpr : public Expr<BinaryExpr<L, R, Op>> {
+private:
+    L left;
+    R right;
+    Shape sh;
+
+public:
+    typedef typename std::common_type<typename L::value_type, typename R::value_type>::type value_type;
+
+    BinaryExpr(const L& left, const R& right) : left(left), right(right), sh(combineShapes(left.shape(), right.shape())) {}
+
+    value_type operator[](size_t k) const {
+        return Op::apply(static_cast<value_type>(left[k]), static_cast<value_type>(right[k]));
+    }
+
+    Shape shape() const { return sh; }
+};
+
+// Число элементов, начиная с которого вычисление делится между потоками
+const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+// Вызов body(begin, end) для частей диапазона [0, count)
+template <typename Body>
+void parallelFor(size_t count, Body body) {
+    unsigned threads = std::thread::hardware_concurrency();
+    if (count < PARALLEL_THRESHOLD || threads <= 1) {
+        body(size_t(0), count);
+        return;
+    }
+
+    threads = static_cast<unsigned>(std::min<size_t>(threads, count / (PARALLEL_THRESHOLD / 4)));
+    size_t step = (count + threads - 1) / threads;
+    std::vector<std::thread> pool;
+    for (size_t begin = step; begin < count; begin += step) {
+        pool.emplace_back(body, begin, std::min(count, begin + step));
+    }
+    body(size_t(0), std::min(count, step));
+    for (std::thread& th : pool) {
+        th.join();
+    }
+}
+
+// Запись значений выражения в out. Каждый элемент результата зависит только
+// от элементов операндов с тем же индексом, поэтому out может совпадать
+// с одним из операндов.
+template <typename T, typename E>
+void evaluate(T* out, const E& expr, size_t count) {
+    parallelFor(count, [out, &expr](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            out[k] = static_cast<T>(expr[k]);
+        }
+    });
+}
+
+// Размер вектора для выражения; матрица подходит, только если она столбец
+inline size_t vectorSize(Shape sh) {
+    if (sh.isScalar() || sh.cols != 1) {
+        throw std::invalid_argument("Expression is not a vector");
+    }
+    return sh.rows;
+}
 
 // Класс Vector для работы с одномерными массивами
+template <typename T = int>
 class Vector {
 private:
-    int* data;
+    T* data;
     size_t size;
 
 public:
     // Конструктор
-    Vector(size_t size) : size(size) {
-        data = new int[size];
-        for (size_t i = 0; i < size; ++i) {
-            data[i] = 0;
+    Vector(size_t size) : data(allocateAligned<T>(size)), size(size) {
+        std::fill(data, data + size, T());
+    }
+
+    // Копирование создает независимую копию данных
+    Vector(const Vector& other) : data(allocateAligned<T>(other.size)), size(other.size) {
+        std::copy(other.data, other.data + size, data);
+    }
+
+    // Перемещение забирает буфер без выделения памяти
+    Vector(Vector&& other) noexcept : data(other.data), size(other.size) {
+        other.data = nullptr;
+        other.size = 0;
+    }
+
+    Vector& operator=(const Vector& other) {
+        if (this != &other) {
+            Vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    Vector& operator=(Vector&& other) noexcept {
+        if (this != &other) {
+            freeAligned(data);
+            data = other.data;
+            size = other.size;
+            other.data = nullptr;
+            other.size = 0;
         }
+        return *this;
+    }
+
+    // Вектор из выражения: элементы вычисляются за один проход
+    template <typename E>
+    Vector(const Expr<E>& expr) : data(nullptr), size(vectorSize(expr.self().shape())) {
+        data = allocateAligned<T>(size);
+        evaluate(data, expr.self(), size);
+    }
+
+    template <typename E>
+    Vector& operator=(const Expr<E>& expr) {
+        if (vectorSize(expr.self().shape()) != size) {
+            Vector result(expr);
+            swap(result);
+        }
+        else {
+            evaluate(data, expr.self(), size);
+        }
+        return *this;
     }
 
     // Деструктор
     ~Vector() {
-        delete[] data;
+        freeAligned(data);
+    }
+
+    void swap(Vector& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
     }
 
     // Перегрузка оператора индексации
-    int& operator[](size_t index) {
+    T& operator[](size_t index) {
         if (index >= size) {
             throw std::out_of_range("Index out of range");
         }
         return data[index];
     }
 
-    const int& operator[](size_t index) const {
+    const T& operator[](size_t index) const {
         if (index >= size) {
             throw std::out_of_range("Index out of range");
         }
@@ -48,7 +306,7 @@ public:
     Vector operator++(int) { // Постфиксный инкремент
         Vector temp = *this;
         ++(*this);
-        return temp;
+        return temp; // Возвращается перемещением
     }
 
     Vector& operator--() { // Префиксный декремент
@@ -75,56 +333,117 @@ public:
     size_t getSize() const {
         return size;
     }
+
+    T* getData() {
+        return data;
+    }
+
+    const T* getData() const {
+        return data;
+    }
 };
 
-// Класс Matrix для работы с двумерными массивами
+// Класс Matrix для работы с двумерными массивами.
+// Элементы хранятся построчно в одном выровненном буфере rows * cols.
+template <typename T = int>
 class Matrix {
 private:
-    int** data;
+    T* data;
     size_t rows;
     size_t cols;
 
 public:
     // Конструктор
-    Matrix(size_t rows, size_t cols) : rows(rows), cols(cols) {
-        data = new int* [rows];
-        for (size_t i = 0; i < rows; ++i) {
-            data[i] = new int[cols];
-            for (size_t j = 0; j < cols; ++j) {
-                data[i][j] = 0;
-            }
+    Matrix(size_t rows, size_t cols) : data(allocateAligned<T>(rows * cols)), rows(rows), cols(cols) {
+        std::fill(data, data + rows * cols, T());
+    }
+
+    // Копирование создает независимую копию данных
+    Matrix(const Matrix& other) : data(allocateAligned<T>(other.rows * other.cols)), rows(other.rows), cols(other.cols) {
+        std::copy(other.data, other.data + rows * cols, data);
+    }
+
+    // Перемещение забирает буфер без выделения памяти
+    Matrix(Matrix&& other) noexcept : data(other.data), rows(other.rows), cols(other.cols) {
+        other.data = nullptr;
+        other.rows = 0;
+        other.cols = 0;
+    }
+
+    Matrix& operator=(const Matrix& other) {
+        if (this != &other) {
+            Matrix copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            freeAligned(data);
+            data = other.data;
+            rows = other.rows;
+            cols = other.cols;
+            other.data = nullptr;
+            other.rows = 0;
+            other.cols = 0;
+        }
+        return *this;
+    }
+
+    // Матрица из выражения: элементы вычисляются за один проход
+    template <typename E>
+    Matrix(const Expr<E>& expr) : data(nullptr), rows(expr.self().shape().rows), cols(expr.self().shape().cols) {
+        if (expr.self().shape().isScalar()) {
+            throw std::invalid_argument("Expression has no size");
         }
+        data = allocateAligned<T>(rows * cols);
+        evaluate(data, expr.self(), rows * cols);
+    }
+
+    template <typename E>
+    Matrix& operator=(const Expr<E>& expr) {
+        Shape sh = expr.self().shape();
+        if (sh.rows != rows || sh.cols != cols) {
+            Matrix result(expr);
+            swap(result);
+        }
+        else {
+            evaluate(data, expr.self(), rows * cols);
+        }
+        return *this;
     }
 
     // Деструктор
     ~Matrix() {
-        for (size_t i = 0; i < rows; ++i) {
-            delete[] data[i];
-        }
-        delete[] data;
+        freeAligned(data);
+    }
+
+    void swap(Matrix& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(rows, other.rows);
+        std::swap(cols, other.cols);
     }
 
     // Методы at и setAt
-    int at(size_t i, size_t j) const {
+    T at(size_t i, size_t j) const {
         if (i >= rows || j >= cols) {
             throw std::out_of_range("Index out of range");
         }
-        return data[i][j];
+        return data[i * cols + j];
     }
 
-    void setAt(size_t i, size_t j, int val) {
+    void setAt(size_t i, size_t j, T val) {
         if (i >= rows || j >= cols) {
             throw std::out_of_range("Index out of range");
         }
-        data[i][j] = val;
+        data[i * cols + j] = val;
     }
 
     // Перегрузка операторов инкремента и декремента
     Matrix& operator++() { // Префиксный инкремент
-        for (size_t i = 0; i < rows; ++i) {
-            for (size_t j = 0; j < cols; ++j) {
-                ++data[i][j];
-            }
+        for (size_t k = 0; k < rows * cols; ++k) {
+            ++data[k];
         }
         return *this;
     }
@@ -132,14 +451,12 @@ public:
     Matrix operator++(int) { // Постфиксный инкремент
         Matrix temp = *this;
         ++(*this);
-        return temp;
+        return temp; // Возвращается перемещением
     }
 
     Matrix& operator--() { // Префиксный декремент
-        for (size_t i = 0; i < rows; ++i) {
-            for (size_t j = 0; j < cols; ++j) {
-                --data[i][j];
-            }
+        for (size_t k = 0; k < rows * cols; ++k) {
+            --data[k];
         }
         return *this;
     }
@@ -154,7 +471,7 @@ public:
     void print() const {
         for (size_t i = 0; i < rows; ++i) {
             for (size_t j = 0; j < cols; ++j) {
-                std::cout << std::setw(4) << data[i][j];
+                std::cout << std::setw(4) << data[i * cols + j];
             }
             std::cout << std::endl;
         }
@@ -167,59 +484,1505 @@ public:
     size_t getCols() const {
         return cols;
     }
+
+    T* getData() {
+        return data;
+    }
+
+    const T* getData() const {
+        return data;
+    }
 };
 
+// Приведение операндов к узлам выражения. Vector считается столбцом.
+template <typename T>
+DataExpr<T> asExpr(const Vector<T>& vec) {
+    return DataExpr<T>(vec.getData(), Shape{ vec.getSize(), 1 });
+}
+
+template <typename T>
+DataExpr<T> asExpr(const Matrix<T>& mat) {
+    return DataExpr<T>(mat.getData(), Shape{ mat.getRows(), mat.getCols() });
+}
+
+template <typename E>
+E asExpr(const Expr<E>& expr) {
+    return expr.self();
+}
+
+template <typename S>
+typename std::enable_if<std::is_arithmetic<S>::value, ScalarExpr<S>>::type asExpr(S value) {
+    return ScalarExpr<S>(value);
+}
+
+// Vector, Matrix или выражение над ними
+template <typename X>
+struct IsOperand : std::is_base_of<Expr<X>, X> {};
+
+template <typename T>
+struct IsOperand<Vector<T>> : std::true_type {};
+
+template <typename T>
+struct IsOperand<Matrix<T>> : std::true_type {};
+
+template <typename L, typename R, typename Op>
+using ExprResult = BinaryExpr<decltype(asExpr(std::declval<const L&>())), decltype(asExpr(std::declval<const R&>())), Op>;
+
+// + и - допускают два операнда или операнд со скаляром
+template <typename L, typename R, typename Op>
+using AnyOperands = typename std::enable_if<
+    (IsOperand<L>::value && (IsOperand<R>::value || std::is_arithmetic<R>::value)) ||
+    (std::is_arithmetic<L>::value && IsOperand<R>::value), ExprResult<L, R, Op>>::type;
+
+// * и / определены только со скаляром: произведение матриц - отдельная операция
+template <typename L, typename R, typename Op>
+using ScalarOperand = typename std::enable_if<
+    (IsOperand<L>::value && std::is_arithmetic<R>::value) ||
+    (std::is_arithmetic<L>::value && IsOperand<R>::value), ExprResult<L, R, Op>>::type;
+
+template <typename L, typename R>
+AnyOperands<L, R, AddOp> operator+(const L& left, const R& right) {
+    return AnyOperands<L, R, AddOp>(asExpr(left), asExpr(right));
+}
+
+template <typename L, typename R>
+AnyOperands<L, R, SubOp> operator-(const L& left, const R& right) {
+    return AnyOperands<L, R, SubOp>(asExpr(left), asExpr(right));
+}
+
+template <typename L, typename R>
+ScalarOperand<L, R, MulOp> operator*(const L& left, const R& right) {
+    return ScalarOperand<L, R, MulOp>(asExpr(left), asExpr(right));
+}
+
+template <typename L, typename R>
+ScalarOperand<L, R, DivOp> operator/(const L& left, const R& right) {
+    return ScalarOperand<L, R, DivOp>(asExpr(left), asExpr(right));
+}
+
 // Функция преобразования из Vector в Matrix
-Matrix convertToMatrix(const Vector& vec, size_t rows, size_t cols) {
+template <typename T>
+Matrix<T> convertToMatrix(const Vector<T>& vec, size_t rows, size_t cols) {
     if (vec.getSize() != rows * cols) {
         throw std::invalid_argument("Size mismatch between vector and matrix");
     }
 
-    Matrix mat(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            mat.setAt(i, j, vec[i * cols + j]);
-        }
-    }
+    // Оба буфера непрерывные, поэтому копируются одним блоком
+    Matrix<T> mat(rows, cols);
+    std::copy(vec.getData(), vec.getData() + rows * cols, mat.getData());
     return mat;
 }
 
 // Функция преобразования из Matrix в Vector
-Vector convertToVector(const Matrix& mat) {
-    size_t rows = mat.getRows();
-    size_t cols = mat.getCols();
+template <typename T>
+Vector<T> convertToVector(const Matrix<T>& mat) {
+    size_t count = mat.getRows() * mat.getCols();
 
-    Vector vec(rows * cols);
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            vec[i * cols + j] = mat.at(i, j);
-        }
-    }
+    Vector<T> vec(count);
+    std::copy(mat.getData(), mat.getData() + count, vec.getData());
     return vec;
 }
 
-int main() {
-    try {
-        // Создание и инициализация вектора
-        Vector vec(6);
-        for (size_t i = 0; i < vec.getSize(); ++i) {
-            vec[i] = static_cast<int>(i + 1);
+// Невладеющее представление одномерного массива с шагом stride.
+// Изменения через представление видны в исходном Vector или Matrix.
+template <typename T = int>
+class VectorView {
+private:
+    T* data;
+    size_t size;
+    size_t stride;
+
+public:
+    VectorView(T* data, size_t size, size_t stride = 1) : data(data), size(size), stride(stride) {}
+
+    VectorView(Vector<T>& vec) : data(vec.getData()), size(vec.getSize()), stride(1) {}
+
+    T& operator[](size_t index) const {
+        if (index >= size) {
+            throw std::out_of_range("Index out of range");
         }
+        return data[index * stride];
+    }
 
-        std::cout << "Original Vector:" << std::endl;
-        vec.print();
+    // Инкремент и декремент меняют элементы исходного хранилища
+    VectorView& operator++() {
+        for (size_t i = 0; i < size; ++i) {
+            ++data[i * stride];
+        }
+        return *this;
+    }
 
-        // Преобразование вектора в матрицу
-        Matrix mat = convertToMatrix(vec, 2, 3);
+    VectorView& operator--() {
+        for (size_t i = 0; i < size; ++i) {
+            --data[i * stride];
+        }
+        return *this;
+    }
 
-        std::cout << "Converted Matrix:" << std::endl;
-        mat.print();
+    // Постфиксные формы возвращают копию прежних значений
+    Vector<T> operator++(int) {
+        Vector<T> old = toVector();
+        ++(*this);
+        return old;
+    }
 
-        // Преобразование матрицы обратно в вектор
-        Vector newVec = convertToVector(mat);
+    Vector<T> operator--(int) {
+        Vector<T> old = toVector();
+        --(*this);
+        return old;
+    }
 
-        std::cout << "Converted Back to Vector:" << std::endl;
-        newVec.print();
+    // Копия элементов в собственный Vector
+    Vector<T> toVector() const {
+        Vector<T> vec(size);
+        for (size_t i = 0; i < size; ++i) {
+            vec.getData()[i] = data[i * stride];
+        }
+        return vec;
+    }
+
+    void print() const {
+        for (size_t i = 0; i < size; ++i) {
+            std::cout << data[i * stride] << " ";
+        }
+        std::cout << std::endl;
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+    size_t getStride() const {
+        return stride;
+    }
+
+    T* getData() const {
+        return data;
+    }
+};
+
+// Невладеющее представление матрицы: элемент (i, j) лежит по адресу
+// data + i * rowStride + j * colStride. Транспонирование и выделение блока
+// только пересчитывают размеры и шаги, не копируя данные.
+template <typename T = int>
+class MatrixView {
+private:
+    T* data;
+    size_t rows;
+    size_t cols;
+    size_t rowStride;
+    size_t colStride;
+
+public:
+    MatrixView(T* data, size_t rows, size_t cols, size_t rowStride, size_t colStride = 1)
+        : data(data), rows(rows), cols(cols), rowStride(rowStride), colStride(colStride) {
+    }
+
+    MatrixView(Matrix<T>& mat)
+        : data(mat.getData()), rows(mat.getRows()), cols(mat.getCols()), rowStride(mat.getCols()), colStride(1) {
+    }
+
+    T at(size_t i, size_t j) const {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data[i * rowStride + j * colStride];
+    }
+
+    void setAt(size_t i, size_t j, T val) const {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        data[i * rowStride + j * colStride] = val;
+    }
+
+    // Транспонированное представление тех же данных
+    MatrixView transpose() const {
+        return MatrixView(data, cols, rows, colStride, rowStride);
+    }
+
+    // Блок blockRows x blockCols с левым верхним углом (row, col)
+    MatrixView block(size_t row, size_t col, size_t blockRows, size_t blockCols) const {
+        if (row + blockRows > rows || col + blockCols > cols) {
+            throw std::out_of_range("Block out of range");
+        }
+        return MatrixView(data + row * rowStride + col * colStride, blockRows, blockCols, rowStride, colStride);
+    }
+
+    VectorView<T> row(size_t i) const {
+        if (i >= rows) {
+            throw std::out_of_range("Index out of range");
+        }
+        return VectorView<T>(data + i * rowStride, cols, colStride);
+    }
+
+    VectorView<T> column(size_t j) const {
+        if (j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        return VectorView<T>(data + j * colStride, rows, rowStride);
+    }
+
+    // Строки идут подряд без промежутков
+    bool isContiguous() const {
+        return colStride == 1 && (rowStride == cols || rows <= 1);
+    }
+
+    // Вся матрица как одномерный массив; возможно только без промежутков
+    VectorView<T> flatten() const {
+        if (!isContiguous()) {
+            throw std::logic_error("View is not contiguous");
+        }
+        return VectorView<T>(data, rows * cols);
+    }
+
+    MatrixView& operator++() {
+        apply([](T& value) { ++value; });
+        return *this;
+    }
+
+    MatrixView& operator--() {
+        apply([](T& value) { --value; });
+        return *this;
+    }
+
+    Matrix<T> operator++(int) {
+        Matrix<T> old = toMatrix();
+        ++(*this);
+        return old;
+    }
+
+    Matrix<T> operator--(int) {
+        Matrix<T> old = toMatrix();
+        --(*this);
+        return old;
+    }
+
+    // Копия элементов в собственную Matrix
+    Matrix<T> toMatrix() const {
+        Matrix<T> mat(rows, cols);
+        T* out = mat.getData();
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                *out++ = data[i * rowStride + j * colStride];
+            }
+        }
+        return mat;
+    }
+
+    void print() const {
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                std::cout << std::setw(4) << data[i * rowStride + j * colStride];
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    size_t getRowStride() const {
+        return rowStride;
+    }
+
+    size_t getColStride() const {
+        return colStride;
+    }
+
+    T* getData() const {
+        return data;
+    }
+
+private:
+    template <typename Op>
+    void apply(Op op) const {
+        if (isContiguous()) {
+            for (size_t k = 0; k < rows * cols; ++k) {
+                op(data[k]);
+            }
+            return;
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                op(data[i * rowStride + j * colStride]);
+            }
+        }
+    }
+};
+
+// Vector как матрица rows x cols без копирования
+template <typename T>
+MatrixView<T> viewAsMatrix(Vector<T>& vec, size_t rows, size_t cols) {
+    if (vec.getSize() != rows * cols) {
+        throw std::invalid_argument("Size mismatch between vector and matrix");
+    }
+    return MatrixView<T>(vec.getData(), rows, cols, cols);
+}
+
+// Matrix как одномерный массив без копирования
+template <typename T>
+VectorView<T> viewAsVector(Matrix<T>& mat) {
+    return VectorView<T>(mat.getData(), mat.getRows() * mat.getCols());
+}
+
+// Умножение и транспонирование матриц.
+// C = A * B считается блоками: KC x NC блок B помещается в L2, MC строк A
+// проходят по нему, а микроядро держит тайл 4 x 16 результата в регистрах.
+// Потоки делят между собой блоки строк результата и не пишут в общие ячейки.
+const size_t GEMM_MC = 64;
+const size_t GEMM_KC = 256;
+const size_t GEMM_NC = 512;
+
+// Параметры одного блока: строки [i0, i1), общий индекс [k0, k1), столбцы [j0, j1)
+struct GemmBlock {
+    size_t i0, i1, k0, k1, j0, j1;
+};
+
+// Блок для произвольного типа: порядок i-k-j дает непрерывный внутренний цикл
+template <typename T>
+void gemmBlockScalar(const T* a, const T* b, T* c, size_t lda, size_t ldb, size_t ldc, GemmBlock blk) {
+    for (size_t i = blk.i0; i < blk.i1; ++i) {
+        for (size_t k = blk.k0; k < blk.k1; ++k) {
+            T aik = a[i * lda + k];
+            const T* bRow = b + k * ldb;
+            T* cRow = c + i * ldc;
+            for (size_t j = blk.j0; j < blk.j1; ++j) {
+                cRow[j] += aik * bRow[j];
+            }
+        }
+    }
+}
+
+#ifdef SIMD_X86
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    if (!(regs[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+const bool HAS_AVX2 = cpuHasAvx2();
+
+// Микроядро 4 x 16 для int32: 8 аккумуляторов, умножение vpmulld и сложение vpaddd
+TARGET_AVX2 void gemmBlockAvx2(const int* a, const int* b, int* c, size_t lda, size_t ldb, size_t ldc, GemmBlock blk) {
+    size_t i = blk.i0;
+    for (; i + 4 <= blk.i1; i += 4) {
+        size_t j = blk.j0;
+        for (; j + 16 <= blk.j1; j += 16) {
+            __m256i acc[4][2];
+            for (int r = 0; r < 4; ++r) {
+                acc[r][0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + (i + r) * ldc + j));
+                acc[r][1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + (i + r) * ldc + j + 8));
+            }
+            for (size_t k = blk.k0; k < blk.k1; ++k) {
+                __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k * ldb + j));
+                __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k * ldb + j + 8));
+                for (int r = 0; r < 4; ++r) {
+                    __m256i aik = _mm256_set1_epi32(a[(i + r) * lda + k]);
+                    acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_mullo_epi32(aik, b0));
+                    acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_mullo_epi32(aik, b1));
+                }
+            }
+            for (int r = 0; r < 4; ++r) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + (i + r) * ldc + j), acc[r][0]);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + (i + r) * ldc + j + 8), acc[r][1]);
+            }
+        }
+        // Столбцы, не вошедшие в тайл
+        if (j < blk.j1) {
+            gemmBlockScalar(a, b, c, lda, ldb, ldc, GemmBlock{ i, i + 4, blk.k0, blk.k1, j, blk.j1 });
+        }
+    }
+    // Строки, не вошедшие в тайл
+    if (i < blk.i1) {
+        gemmBlockScalar(a, b, c, lda, ldb, ldc, GemmBlock{ i, blk.i1, blk.k0, blk.k1, blk.j0, blk.j1 });
+    }
+}
+#endif
+
+template <typename T>
+void gemmBlock(const T* a, const T* b, T* c, size_t lda, size_t ldb, size_t ldc, GemmBlock blk) {
+    gemmBlockScalar(a, b, c, lda, ldb, ldc, blk);
+}
+
+// Для int32 используется векторное микроядро, если процессор поддерживает AVX2
+inline void gemmBlock(const int* a, const int* b, int* c, size_t lda, size_t ldb, size_t ldc, GemmBlock blk) {
+#ifdef SIMD_X86
+    if (HAS_AVX2) {
+        gemmBlockAvx2(a, b, c, lda, ldb, ldc, blk);
+        return;
+    }
+#endif
+    gemmBlockScalar(a, b, c, lda, ldb, ldc, blk);
+}
+
+// Произведение матриц left (m x n) и right (n x p)
+template <typename T>
+Matrix<T> multiply(const Matrix<T>& left, const Matrix<T>& right) {
+    if (left.getCols() != right.getRows()) {
+        throw std::invalid_argument("Size mismatch in matrix multiplication");
+    }
+
+    size_t m = left.getRows();
+    size_t n = left.getCols();
+    size_t p = right.getCols();
+    Matrix<T> result(m, p);
+
+    const T* a = left.getData();
+    const T* b = right.getData();
+    T* c = result.getData();
+    size_t rowBlocks = (m + GEMM_MC - 1) / GEMM_MC;
+
+    // Малые произведения считаются в одном потоке
+    unsigned threads = std::thread::hardware_concurrency();
+    if (m * n * p < PARALLEL_THRESHOLD * 64 || threads <= 1) {
+        threads = 1;
+    }
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, rowBlocks)));
+
+    auto work = [=](unsigned t) {
+        for (size_t rb = t; rb < rowBlocks; rb += threads) {
+            size_t i0 = rb * GEMM_MC;
+            size_t i1 = std::min(m, i0 + GEMM_MC);
+            for (size_t j0 = 0; j0 < p; j0 += GEMM_NC) {
+                size_t j1 = std::min(p, j0 + GEMM_NC);
+                for (size_t k0 = 0; k0 < n; k0 += GEMM_KC) {
+                    size_t k1 = std::min(n, k0 + GEMM_KC);
+                    gemmBlock(a, b, c, n, p, p, GemmBlock{ i0, i1, k0, k1, j0, j1 });
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    return result;
+}
+
+template <typename T>
+Matrix<T> operator*(const Matrix<T>& left, const Matrix<T>& right) {
+    return multiply(left, right);
+}
+
+// Транспонирование плитками 32 x 32: и чтение, и запись остаются в пределах
+// нескольких строк кэша вместо прохода по столбцу через всю матрицу
+template <typename T>
+Matrix<T> transpose(const Matrix<T>& mat) {
+    const size_t TILE = 32;
+    size_t rows = mat.getRows();
+    size_t cols = mat.getCols();
+    Matrix<T> result(cols, rows);
+
+    const T* src = mat.getData();
+    T* dst = result.getData();
+    if (rows == 0 || cols == 0) {
+        return result;
+    }
+    size_t tileSize = TILE * cols;
+
+    // Диапазон элементов из parallelFor округляется до целых полос плиток
+    parallelFor(rows * cols, [=](size_t begin, size_t end) {
+        size_t tileBegin = (begin + tileSize - 1) / tileSize;
+        size_t tileEnd = (end + tileSize - 1) / tileSize;
+        for (size_t ti = tileBegin; ti < tileEnd; ++ti) {
+            size_t i0 = ti * TILE;
+            size_t i1 = std::min(rows, i0 + TILE);
+            for (size_t j0 = 0; j0 < cols; j0 += TILE) {
+                size_t j1 = std::min(cols, j0 + TILE);
+                for (size_t i = i0; i < i1; ++i) {
+                    for (size_t j = j0; j < j1; ++j) {
+                        dst[j * rows + i] = src[i * cols + j];
+                    }
+                }
+            }
+        }
+    });
+    return result;
+}
+
+// Произведение классическим тройным циклом, для сравнения в замерах
+template <typename T>
+Matrix<T> multiplyNaive(const Matrix<T>& left, const Matrix<T>& right) {
+    size_t m = left.getRows();
+    size_t n = left.getCols();
+    size_t p = right.getCols();
+    Matrix<T> result(m, p);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < p; ++j) {
+            T sum = T();
+            for (size_t k = 0; k < n; ++k) {
+                sum += left.getData()[i * n + k] * right.getData()[k * p + j];
+            }
+            result.getData()[i * p + j] = sum;
+        }
+    }
+    return result;
+}
+
+// Скорость умножения int32 в GOPS (2 * n^3 операций) для n от 64 до 4096.
+// Тройной цикл замеряется только до 1024: дальше он идет минутами.
+void runGemmBenchmark() {
+    std::cout << std::setw(6) << "n" << std::setw(12) << "naive" << std::setw(12) << "blocked"
+        << std::setw(12) << "transpose" << "  (GOPS, GOPS, GB/s)" << std::endl;
+
+    for (size_t n = 64; n <= 4096; n *= 2) {
+        Matrix<int> a(n, n);
+        Matrix<int> b(n, n);
+        for (size_t k = 0; k < n * n; ++k) {
+            a.getData()[k] = static_cast<int>(k % 7) - 3;
+            b.getData()[k] = static_cast<int>(k % 5) - 2;
+        }
+
+        double ops = 2.0 * n * n * n;
+        int repeats = n <= 512 ? 5 : 1;
+
+        auto timeOf = [&](auto run) {
+            double best = 1e100;
+            for (int r = 0; r < repeats; ++r) {
+                auto begin = std::chrono::steady_clock::now();
+                run();
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+                best = std::min(best, elapsed.count());
+            }
+            return best;
+        };
+
+        Matrix<int> fast(0, 0);
+        double blocked = timeOf([&]() { fast = a * b; });
+        double transposed = timeOf([&]() { Matrix<int> t = transpose(a); });
+
+        std::cout << std::setw(6) << n;
+        if (n <= 1024) {
+            Matrix<int> slow(0, 0);
+            double naive = timeOf([&]() { slow = multiplyNaive(a, b); });
+            std::cout << std::setw(12) << ops / naive / 1e9;
+            if (std::memcmp(slow.getData(), fast.getData(), n * n * sizeof(int)) != 0) {
+                std::cout << " (mismatch!)";
+            }
+        }
+        else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::setw(12) << ops / blocked / 1e9
+            << std::setw(12) << 2.0 * n * n * sizeof(int) / transposed / 1e9 << std::endl;
+    }
+}
+
+// Разреженная матрица в формате CSR: для строки i ненулевые элементы лежат
+// в values[rowStart[i] .. rowStart[i + 1]), их столбцы - в columns.
+// ++ и -- меняют только общее смещение offset, которое добавляется ко всем
+// элементам, включая неявные нули, поэтому матрица не становится плотной.
+template <typename T = int>
+class SparseMatrix {
+private:
+    size_t rows;
+    size_t cols;
+    std::vector<size_t> rowStart;
+    std::vector<size_t> columns;
+    std::vector<T> values;
+    T offset;
+
+    // Позиция элемента (i, j) в values или rowStart[i + 1], если его нет
+    size_t find(size_t i, size_t j) const {
+        auto first = columns.begin() + rowStart[i];
+        auto last = columns.begin() + rowStart[i + 1];
+        auto it = std::lower_bound(first, last, j);
+        return it != last && *it == j ? static_cast<size_t>(it - columns.begin()) : rowStart[i + 1];
+    }
+
+public:
+    // Пустая матрица rows x cols: все элементы равны нулю
+    SparseMatrix(size_t rows, size_t cols) : rows(rows), cols(cols), rowStart(rows + 1, 0), offset() {}
+
+    // Готовые массивы CSR; столбцы в каждой строке должны возрастать
+    SparseMatrix(size_t rows, size_t cols, std::vector<size_t> rowStart, std::vector<size_t> columns, std::vector<T> values)
+        : rows(rows), cols(cols), rowStart(std::move(rowStart)), columns(std::move(columns)), values(std::move(values)), offset() {
+        if (this->rowStart.size() != rows + 1 || this->rowStart[rows] != this->columns.size() ||
+            this->columns.size() != this->values.size()) {
+            throw std::invalid_argument("Inconsistent CSR arrays");
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t k = this->rowStart[i]; k < this->rowStart[i + 1]; ++k) {
+                if (this->columns[k] >= cols || (k > this->rowStart[i] && this->columns[k] <= this->columns[k - 1])) {
+                    throw std::invalid_argument("Invalid column index in CSR arrays");
+                }
+            }
+        }
+    }
+
+    // Методы at и setAt
+    T at(size_t i, size_t j) const {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        size_t k = find(i, j);
+        return k < rowStart[i + 1] ? values[k] + offset : offset;
+    }
+
+    // Запись отсутствующего элемента сдвигает хвост массивов, поэтому
+    // для заполнения большого числа элементов нужен SparseBuilder
+    void setAt(size_t i, size_t j, T val) {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        T stored = val - offset;
+        size_t k = find(i, j);
+        if (k < rowStart[i + 1]) {
+            values[k] = stored;
+            return;
+        }
+        if (stored == T()) {
+            return;
+        }
+
+        auto first = columns.begin() + rowStart[i];
+        size_t pos = static_cast<size_t>(std::lower_bound(first, columns.begin() + rowStart[i + 1], j) - columns.begin());
+        columns.insert(columns.begin() + pos, j);
+        values.insert(values.begin() + pos, stored);
+        for (size_t r = i + 1; r <= rows; ++r) {
+            ++rowStart[r];
+        }
+    }
+
+    // Перегрузка операторов инкремента и декремента
+    SparseMatrix& operator++() { // Префиксный инкремент
+        ++offset;
+        return *this;
+    }
+
+    SparseMatrix operator++(int) { // Постфиксный инкремент
+        SparseMatrix temp = *this;
+        ++offset;
+        return temp;
+    }
+
+    SparseMatrix& operator--() { // Префиксный декремент
+        --offset;
+        return *this;
+    }
+
+    SparseMatrix operator--(int) { // Постфиксный декремент
+        SparseMatrix temp = *this;
+        --offset;
+        return temp;
+    }
+
+    // Вывод массива
+    void print() const {
+        for (size_t i = 0; i < rows; ++i) {
+            size_t k = rowStart[i];
+            for (size_t j = 0; j < cols; ++j) {
+                T val = offset;
+                if (k < rowStart[i + 1] && columns[k] == j) {
+                    val += values[k++];
+                }
+                std::cout << std::setw(4) << val;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    // Число хранимых элементов
+    size_t nonZeros() const {
+        return values.size();
+    }
+
+    T getOffset() const {
+        return offset;
+    }
+
+    const std::vector<size_t>& getRowStart() const {
+        return rowStart;
+    }
+
+    const std::vector<size_t>& getColumns() const {
+        return columns;
+    }
+
+    const std::vector<T>& getValues() const {
+        return values;
+    }
+};
+
+// Сборка SparseMatrix из троек (строка, столбец, значение) в формате COO.
+// Тройки добавляются в любом порядке, повторы одной позиции складываются.
+template <typename T = int>
+class SparseBuilder {
+private:
+    struct Entry {
+        size_t row;
+        size_t col;
+        T value;
+    };
+
+    size_t rows;
+    size_t cols;
+    std::vector<Entry> entries;
+
+public:
+    SparseBuilder(size_t rows, size_t cols) : rows(rows), cols(cols) {}
+
+    void add(size_t i, size_t j, T val) {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        entries.push_back(Entry{ i, j, val });
+    }
+
+    void reserve(size_t count) {
+        entries.reserve(count);
+    }
+
+    // Тройки раскладываются по строкам подсчетом, затем каждая строка
+    // сортируется по столбцам; нулевые суммы не сохраняются
+    SparseMatrix<T> build() const {
+        std::vector<size_t> rowStart(rows + 1, 0);
+        for (const Entry& e : entries) {
+            ++rowStart[e.row + 1];
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            rowStart[i + 1] += rowStart[i];
+        }
+
+        std::vector<std::pair<size_t, T>> byRow(entries.size());
+        std::vector<size_t> next(rowStart.begin(), rowStart.end() - 1);
+        for (const Entry& e : entries) {
+            byRow[next[e.row]++] = std::make_pair(e.col, e.value);
+        }
+
+        std::vector<size_t> columns;
+        std::vector<T> values;
+        columns.reserve(entries.size());
+        values.reserve(entries.size());
+        std::vector<size_t> compactStart(rows + 1, 0);
+
+        for (size_t i = 0; i < rows; ++i) {
+            auto first = byRow.begin() + rowStart[i];
+            auto last = byRow.begin() + rowStart[i + 1];
+            std::sort(first, last, [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) {
+                return a.first < b.first;
+            });
+            for (auto it = first; it != last;) {
+                size_t col = it->first;
+                T sum = T();
+                for (; it != last && it->first == col; ++it) {
+                    sum += it->second;
+                }
+                if (sum != T()) {
+                    columns.push_back(col);
+                    values.push_back(sum);
+                }
+            }
+            compactStart[i + 1] = columns.size();
+        }
+
+        return SparseMatrix<T>(rows, cols, std::move(compactStart), std::move(columns), std::move(values));
+    }
+};
+
+// Функция преобразования из Matrix в SparseMatrix: сохраняются ненулевые элементы
+template <typename T>
+SparseMatrix<T> convertToSparse(const Matrix<T>& mat) {
+    size_t rows = mat.getRows();
+    size_t cols = mat.getCols();
+    const T* data = mat.getData();
+
+    std::vector<size_t> rowStart(rows + 1, 0);
+    std::vector<size_t> columns;
+    std::vector<T> values;
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            if (data[i * cols + j] != T()) {
+                columns.push_back(j);
+                values.push_back(data[i * cols + j]);
+            }
+        }
+        rowStart[i + 1] = columns.size();
+    }
+    return SparseMatrix<T>(rows, cols, std::move(rowStart), std::move(columns), std::move(values));
+}
+
+// Функция преобразования из Vector в SparseMatrix rows x cols
+template <typename T>
+SparseMatrix<T> convertToSparse(const Vector<T>& vec, size_t rows, size_t cols) {
+    return convertToSparse(convertToMatrix(vec, rows, cols));
+}
+
+// Функция преобразования из SparseMatrix в Matrix; смещение применяется ко всем элементам
+template <typename T>
+Matrix<T> convertToMatrix(const SparseMatrix<T>& sparse) {
+    size_t cols = sparse.getCols();
+    Matrix<T> mat(sparse.getRows(), cols);
+    T* data = mat.getData();
+    std::fill(data, data + sparse.getRows() * cols, sparse.getOffset());
+
+    const std::vector<size_t>& rowStart = sparse.getRowStart();
+    const std::vector<size_t>& columns = sparse.getColumns();
+    const std::vector<T>& values = sparse.getValues();
+    for (size_t i = 0; i < sparse.getRows(); ++i) {
+        for (size_t k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            data[i * cols + columns[k]] += values[k];
+        }
+    }
+    return mat;
+}
+
+// Функция преобразования из SparseMatrix в Vector
+template <typename T>
+Vector<T> convertToVector(const SparseMatrix<T>& sparse) {
+    return convertToVector(convertToMatrix(sparse));
+}
+
+// Произведение разреженной матрицы на вектор. Строки делятся между потоками
+// так, чтобы на каждый приходилось примерно поровну хранимых элементов:
+// диапазон parallelFor по rows + nonZeros переводится в границы строк.
+// Смещение дает ко всем строкам одинаковую добавку offset * sum(x).
+template <typename T>
+Vector<T> multiply(const SparseMatrix<T>& mat, const Vector<T>& vec) {
+    if (mat.getCols() != vec.getSize()) {
+        throw std::invalid_argument("Size mismatch in matrix-vector multiplication");
+    }
+
+    size_t rows = mat.getRows();
+    const size_t* rowStart = mat.getRowStart().data();
+    const size_t* columns = mat.getColumns().data();
+    const T* values = mat.getValues().data();
+    const T* x = vec.getData();
+
+    T shift = T();
+    if (mat.getOffset() != T()) {
+        T sum = T();
+        for (size_t j = 0; j < vec.getSize(); ++j) {
+            sum += x[j];
+        }
+        shift = mat.getOffset() * sum;
+    }
+
+    Vector<T> result(rows);
+    T* y = result.getData();
+
+    // Первая строка, у которой rowStart[i] + i не меньше pos
+    auto rowAt = [=](size_t pos) {
+        size_t lo = 0, hi = rows;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (rowStart[mid] + mid < pos) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return lo;
+    };
+
+    parallelFor(rows + mat.nonZeros(), [=](size_t begin, size_t end) {
+        size_t rowEnd = rowAt(end);
+        for (size_t i = rowAt(begin); i < rowEnd; ++i) {
+            T sum = shift;
+            for (size_t k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                sum += values[k] * x[columns[k]];
+            }
+            y[i] = sum;
+        }
+    });
+    return result;
+}
+
+template <typename T>
+Vector<T> operator*(const SparseMatrix<T>& mat, const Vector<T>& vec) {
+    return multiply(mat, vec);
+}
+
+// Матрица в файле, отображенном в память. Файл начинается с заголовка
+// MatrixFileHeader, за ним построчно идут элементы. Страницы подгружаются
+// системой по первому обращению, поэтому матрица может быть больше
+// оперативной памяти; изменения записываются обратно в файл.
+const uint32_t MATRIX_FILE_VERSION = 1;
+
+// Коды типов элементов в заголовке
+template <typename T>
+struct MatrixElementType;
+
+template <>
+struct MatrixElementType<int32_t> {
+    static const uint32_t code = 1;
+};
+
+template <>
+struct MatrixElementType<int64_t> {
+    static const uint32_t code = 2;
+};
+
+template <>
+struct MatrixElementType<float> {
+    static const uint32_t code = 3;
+};
+
+template <>
+struct MatrixElementType<double> {
+    static const uint32_t code = 4;
+};
+
+// Заголовок занимает строку кэша, чтобы данные были выровнены по CACHE_LINE
+struct MatrixFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t elementType;
+    uint32_t elementSize;
+    uint64_t rows;
+    uint64_t cols;
+    char reserved[32];
+};
+
+static_assert(sizeof(MatrixFileHeader) == CACHE_LINE, "Matrix file header must fill one cache line");
+
+const char MATRIX_FILE_MAGIC[4] = { 'M', 'T', 'R', 'X' };
+
+// Ожидаемый порядок обращения к страницам
+enum class AccessHint {
+    Normal,
+    Sequential, // Агрессивное чтение вперед, прочитанные страницы вытесняются первыми
+    Random,     // Без чтения вперед
+    WillNeed    // Начать подгрузку заранее
+};
+
+template <typename T = int>
+class MappedMatrix {
+private:
+    char* base;
+    size_t fileSize;
+    T* data;
+    size_t rows;
+    size_t cols;
+    bool writable;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+
+    // Открытие файла нужного размера и отображение его целиком
+    void map(const std::string& path, bool create, uint64_t size) {
+#if defined(_WIN32)
+        DWORD access = writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+        file = CreateFileA(path.c_str(), access, FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        LARGE_INTEGER length;
+        if (create) {
+            length.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFilePointerEx(file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+                CloseHandle(file);
+                throw std::runtime_error("Cannot resize file: " + path);
+            }
+        }
+        if (!GetFileSizeEx(file, &length)) {
+            CloseHandle(file);
+            throw std::runtime_error("Cannot read file size: " + path);
+        }
+        fileSize = static_cast<size_t>(length.QuadPart);
+        if (fileSize < sizeof(MatrixFileHeader)) {
+            CloseHandle(file);
+            throw std::runtime_error("File is too small for a matrix header: " + path);
+        }
+        mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+        base = mapping ? static_cast<char*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        if (base == nullptr) {
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+#else
+        fd = ::open(path.c_str(), writable ? (create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR) : O_RDONLY, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        // Новый файл растягивается без записи: непрочитанные страницы остаются нулевыми
+        if (create && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot resize file: " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot read file size: " + path);
+        }
+        fileSize = static_cast<size_t>(info.st_size);
+        if (fileSize < sizeof(MatrixFileHeader)) {
+            close(fd);
+            throw std::runtime_error("File is too small for a matrix header: " + path);
+        }
+        void* view = mmap(nullptr, fileSize, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+        base = static_cast<char*>(view);
+#endif
+    }
+
+    void unmap() {
+        if (base == nullptr) {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(base);
+        CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        munmap(base, fileSize);
+        close(fd);
+#endif
+        base = nullptr;
+    }
+
+    // Применение операции ко всем элементам за один последовательный проход
+    template <typename Op>
+    void apply(Op op) {
+        if (!writable) {
+            throw std::logic_error("Matrix file is opened read-only");
+        }
+        T* elements = data;
+        parallelFor(rows * cols, [elements, op](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                op(elements[k]);
+            }
+        });
+    }
+
+public:
+    // Создание нового файла с матрицей rows x cols, заполненной нулями
+    MappedMatrix(const std::string& path, size_t rows, size_t cols)
+        : base(nullptr), fileSize(0), data(nullptr), rows(rows), cols(cols), writable(true) {
+        // Размер файла должен помещаться и в size_t (отображение), и в
+        // знаковое 64-битное смещение (ftruncate, SetFilePointerEx)
+        const uint64_t maxFileSize = std::min<uint64_t>(SIZE_MAX, INT64_MAX);
+        if (cols != 0 && rows > (maxFileSize - sizeof(MatrixFileHeader)) / sizeof(T) / cols) {
+            throw std::invalid_argument("Matrix is too large for a file");
+        }
+        map(path, true, sizeof(MatrixFileHeader) + static_cast<uint64_t>(rows) * cols * sizeof(T));
+
+        MatrixFileHeader header = {};
+        std::memcpy(header.magic, MATRIX_FILE_MAGIC, sizeof(header.magic));
+        header.version = MATRIX_FILE_VERSION;
+        header.elementType = MatrixElementType<T>::code;
+        header.elementSize = sizeof(T);
+        header.rows = rows;
+        header.cols = cols;
+        std::memcpy(base, &header, sizeof(header));
+        data = reinterpret_cast<T*>(base + sizeof(MatrixFileHeader));
+    }
+
+    // Открытие существующего файла; заголовок должен совпадать с типом T
+    explicit MappedMatrix(const std::string& path, bool writable = true)
+        : base(nullptr), fileSize(0), data(nullptr), rows(0), cols(0), writable(writable) {
+        map(path, false, 0);
+
+        MatrixFileHeader header;
+        std::memcpy(&header, base, sizeof(header));
+        const char* problem = nullptr;
+        if (std::memcmp(header.magic, MATRIX_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            problem = "Not a matrix file: ";
+        }
+        else if (header.version != MATRIX_FILE_VERSION) {
+            problem = "Unsupported matrix file version: ";
+        }
+        else if (header.elementType != MatrixElementType<T>::code || header.elementSize != sizeof(T)) {
+            problem = "Element type mismatch in matrix file: ";
+        }
+        else if (header.cols != 0 && header.rows > (fileSize - sizeof(MatrixFileHeader)) / sizeof(T) / header.cols) {
+            problem = "Matrix file is truncated: ";
+        }
+        if (problem != nullptr) {
+            unmap();
+            throw std::runtime_error(problem + path);
+        }
+
+        rows = static_cast<size_t>(header.rows);
+        cols = static_cast<size_t>(header.cols);
+        data = reinterpret_cast<T*>(base + sizeof(MatrixFileHeader));
+    }
+
+    // Отображение нельзя копировать; копию на куче дает convertToMatrix
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    ~MappedMatrix() {
+        unmap();
+    }
+
+    // Методы at и setAt
+    T at(size_t i, size_t j) const {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data[i * cols + j];
+    }
+
+    void setAt(size_t i, size_t j, T val) {
+        if (i >= rows || j >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        if (!writable) {
+            throw std::logic_error("Matrix file is opened read-only");
+        }
+        data[i * cols + j] = val;
+    }
+
+    // Префиксные инкремент и декремент; постфиксных нет, так как они
+    // потребовали бы копии всей матрицы
+    MappedMatrix& operator++() {
+        apply([](T& x) { ++x; });
+        return *this;
+    }
+
+    MappedMatrix& operator--() {
+        apply([](T& x) { --x; });
+        return *this;
+    }
+
+    // Подсказка системе о порядке обращения к строкам [rowBegin, rowEnd).
+    // В Windows аналог madvise есть только для WillNeed.
+    void advise(AccessHint hint, size_t rowBegin = 0, size_t rowEnd = SIZE_MAX) {
+        rowEnd = std::min(rowEnd, rows);
+        if (rowBegin >= rowEnd || cols == 0) {
+            return;
+        }
+        // madvise принимает адрес, выровненный по странице
+        size_t first = sizeof(MatrixFileHeader) + rowBegin * cols * sizeof(T);
+        size_t last = sizeof(MatrixFileHeader) + rowEnd * cols * sizeof(T);
+#if defined(_WIN32)
+        if (hint == AccessHint::WillNeed) {
+            WIN32_MEMORY_RANGE_ENTRY range = { base + first, last - first };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+#else
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        first = first / page * page;
+        int advice = MADV_NORMAL;
+        switch (hint) {
+        case AccessHint::Sequential: advice = MADV_SEQUENTIAL; break;
+        case AccessHint::Random: advice = MADV_RANDOM; break;
+        case AccessHint::WillNeed: advice = MADV_WILLNEED; break;
+        default: break;
+        }
+        madvise(base + first, last - first, advice);
+#endif
+    }
+
+    // Запись измененных страниц на диск
+    void flush() {
+        if (!writable) {
+            return;
+        }
+#if defined(_WIN32)
+        FlushViewOfFile(base, 0);
+        FlushFileBuffers(file);
+#else
+        msync(base, fileSize, MS_SYNC);
+#endif
+    }
+
+    // Представления без копирования, как у обычной Matrix
+    MatrixView<T> view() {
+        return MatrixView<T>(data, rows, cols, cols);
+    }
+
+    VectorView<T> viewAsVector() {
+        return VectorView<T>(data, rows * cols);
+    }
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    T* getData() {
+        return data;
+    }
+
+    const T* getData() const {
+        return data;
+    }
+};
+
+// Копия файловой матрицы на куче
+template <typename T>
+Matrix<T> convertToMatrix(const MappedMatrix<T>& mapped) {
+    Matrix<T> mat(mapped.getRows(), mapped.getCols());
+    std::copy(mapped.getData(), mapped.getData() + mapped.getRows() * mapped.getCols(), mat.getData());
+    return mat;
+}
+
+// Файловая матрица как одномерный массив без копирования
+template <typename T>
+VectorView<T> viewAsVector(MappedMatrix<T>& mapped) {
+    return mapped.viewAsVector();
+}
+
+// Потоковый проход по файловой матрице размером в несколько гигабайт:
+// заполнение, суммирование с подсказкой Sequential, ++ на месте и
+// случайное чтение с подсказкой Random. Если файл помещается в кэш
+// страниц, повторные проходы идут из памяти, а не с диска.
+void runMappedBenchmark(const std::string& path, double gigabytes = 4) {
+    const size_t cols = 1 << 14;
+    size_t rows = static_cast<size_t>(gigabytes * (1 << 30) / (cols * sizeof(int32_t)));
+    double bytes = static_cast<double>(rows) * cols * sizeof(int32_t);
+
+    auto measure = [&](const char* title, double volume, auto pass) {
+        auto begin = std::chrono::steady_clock::now();
+        long long sum = pass();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << std::setw(24) << title << ": " << std::setw(8) << elapsed.count() * 1e3 << " ms, "
+            << volume / elapsed.count() / 1e9 << " GB/s (sum " << sum << ")" << std::endl;
+    };
+
+    std::cout << "Mapped matrix " << rows << "x" << cols << " (" << bytes / (1 << 30) << " GiB) in " << path << std::endl;
+    {
+        MappedMatrix<int32_t> mat(path, rows, cols);
+        mat.advise(AccessHint::Sequential);
+        measure("fill", bytes, [&]() {
+            int32_t* data = mat.getData();
+            parallelFor(rows * cols, [data](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                    data[k] = static_cast<int32_t>(k & 0xFF);
+                }
+            });
+            return 0LL;
+        });
+        measure("flush", bytes, [&]() {
+            mat.flush();
+            return 0LL;
+        });
+    }
+
+    MappedMatrix<int32_t> mat(path);
+    mat.advise(AccessHint::Sequential);
+    auto sumAll = [&]() {
+        const int32_t* data = mat.getData();
+        long long sum = 0;
+        for (size_t k = 0; k < rows * cols; ++k) {
+            sum += data[k];
+        }
+        return sum;
+    };
+    measure("sequential sum", bytes, sumAll);
+    measure("++ in place", 2 * bytes, [&]() {
+        ++mat;
+        return 0LL;
+    });
+    measure("sequential sum after ++", bytes, sumAll);
+
+    // Случайные строки: по одному элементу с каждой страницы строки
+    mat.advise(AccessHint::Random);
+    const size_t samples = 1 << 16;
+    measure("random rows", static_cast<double>(samples) * cols * sizeof(int32_t), [&]() {
+        uint64_t state = 12345;
+        long long sum = 0;
+        for (size_t s = 0; s < samples; ++s) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            size_t i = static_cast<size_t>(state >> 33) % rows;
+            for (size_t j = 0; j < cols; j += 1024) {
+                sum += mat.at(i, j);
+            }
+        }
+        return sum;
+    });
+}
+
+// Обход большой матрицы: старая схема с отдельной строкой на куче,
+// непрерывный буфер по строкам и непрерывный буфер по столбцам
+void runBenchmark(size_t n = 4096, int repeats = 5) {
+    // Старое размещение: каждая строка - отдельное выделение памяти
+    int** scattered = new int* [n];
+    for (size_t i = 0; i < n; ++i) {
+        scattered[i] = new int[n];
+        for (size_t j = 0; j < n; ++j) {
+            scattered[i][j] = static_cast<int>(i + j);
+        }
+    }
+
+    Matrix<int> mat(n, n);
+    int* data = mat.getData();
+    for (size_t k = 0; k < n * n; ++k) {
+        data[k] = static_cast<int>(k / n + k % n);
+    }
+
+    auto measure = [&](const char* title, auto traverse) {
+        double best = 1e100;
+        long long sum = 0;
+        for (int r = 0; r < repeats; ++r) {
+            auto begin = std::chrono::steady_clock::now();
+            sum += traverse();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            best = std::min(best, elapsed.count());
+        }
+        std::cout << std::setw(24) << title << ": " << std::setw(8) << best * 1e3 << " ms, "
+            << n * n * sizeof(int) / best / 1e9 << " GB/s (sum " << sum << ")" << std::endl;
+    };
+
+    std::cout << "Matrix " << n << "x" << n << std::endl;
+    measure("int** by rows", [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                sum += scattered[i][j];
+        return sum;
+    });
+    measure("int** by columns", [&]() {
+        long long sum = 0;
+        for (size_t j = 0; j < n; ++j)
+            for (size_t i = 0; i < n; ++i)
+                sum += scattered[i][j];
+        return sum;
+    });
+    measure("contiguous by rows", [&]() {
+        long long sum = 0;
+        for (size_t k = 0; k < n * n; ++k)
+            sum += data[k];
+        return sum;
+    });
+    measure("contiguous by columns", [&]() {
+        long long sum = 0;
+        for (size_t j = 0; j < n; ++j)
+            for (size_t i = 0; i < n; ++i)
+                sum += data[i * n + j];
+        return sum;
+    });
+    measure("operator++", [&]() {
+        ++mat;
+        return 0LL;
+    });
+    measure("postfix operator++", [&]() {
+        Matrix<int> old = mat++;
+        return static_cast<long long>(old.getRows());
+    });
+
+    // Одно выражение против цепочки операций с временными матрицами
+    Matrix<int> other = mat;
+    measure("fused m + 1 - other * 2", [&]() {
+        Matrix<int> result = mat + 1 - other * 2;
+        return static_cast<long long>(result.at(0, 0));
+    });
+    measure("separate passes", [&]() {
+        Matrix<int> plusOne = mat + 1;
+        Matrix<int> twice = other * 2;
+        Matrix<int> result = plusOne - twice;
+        return static_cast<long long>(result.at(0, 0));
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+        delete[] scattered[i];
+    }
+    delete[] scattered;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        runBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-gemm") == 0) {
+        runGemmBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-mapped") == 0) {
+        std::string path = argc > 2 ? argv[2] : "matrix.bin";
+        try {
+            runMappedBenchmark(path, argc > 3 ? std::atof(argv[3]) : 4);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            std::remove(path.c_str());
+            return 1;
+        }
+        std::remove(path.c_str());
+        return 0;
+    }
+
+    try {
+        // Создание и инициализация вектора
+        Vector<int> vec(6);
+        for (size_t i = 0; i < vec.getSize(); ++i) {
+            vec[i] = static_cast<int>(i + 1);
+        }
+
+        std::cout << "Original Vector:" << std::endl;
+        vec.print();
+
+        // Преобразование вектора в матрицу
+        Matrix<int> mat = convertToMatrix(vec, 2, 3);
+
+        std::cout << "Converted Matrix:" << std::endl;
+        mat.print();
+
+        // Преобразование матрицы обратно в вектор
+        Vector<int> newVec = convertToVector(mat);
+
+        std::cout << "Converted Back to Vector:" << std::endl;
+        newVec.print();
+
+        // Представления без копирования: транспонирование и инкремент блока
+        MatrixView<int> view = viewAsMatrix(vec, 2, 3);
+        std::cout << "Transposed View:" << std::endl;
+        view.transpose().print();
+
+        ++view.block(0, 1, 2, 2);
+        std::cout << "Vector After Incrementing Block (0, 1) 2x2:" << std::endl;
+        vec.print();
+
+        // Разреженная матрица: ++ меняет только общее смещение
+        SparseBuilder<int> builder(3, 4);
+        builder.add(0, 1, 5);
+        builder.add(2, 3, -2);
+        builder.add(0, 1, 1);
+        SparseMatrix<int> sparse = builder.build();
+        ++sparse;
+        std::cout << "Sparse Matrix After Increment (" << sparse.nonZeros() << " stored):" << std::endl;
+        sparse.print();
+
+        Vector<int> ones(4);
+        ++ones;
+        std::cout << "Sparse Matrix * (1, 1, 1, 1):" << std::endl;
+        (sparse * ones).print();
 
     }
     catch (const std::exception& e) {
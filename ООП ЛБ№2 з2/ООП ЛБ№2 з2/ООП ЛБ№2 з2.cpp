@@ -1,13 +1,620 @@
 ﻿#include <iostream>
 #include <cmath>
 #include <cstring>
+#include <cstdio>
 #include <sstream>
+#include <stdexcept>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <exception>
+#include <atomic>
+#include <mutex>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
-class Fraction {
+// 128-битные целые есть только в GCC и Clang
+#if defined(__SIZEOF_INT128__)
+#define FRACTION_HAS_INT128 1
+#endif
+
+// Беззнаковый тип той же ширины; std::make_unsigned не обязан знать __int128
+template <typename Int>
+struct MakeUnsigned : std::make_unsigned<Int> {};
+
+#ifdef FRACTION_HAS_INT128
+template <>
+struct MakeUnsigned<__int128> {
+    typedef unsigned __int128 type;
+};
+#endif
+
+// Число младших нулевых бит ненулевого значения
+inline int ctz32(uint32_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+inline int ctz64(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#elif defined(_MSC_VER)
+    uint32_t low = static_cast<uint32_t>(x);
+    return low != 0 ? ctz32(low) : 32 + ctz32(static_cast<uint32_t>(x >> 32));
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+template <typename U>
+int countTrailingZeros(U x) {
+    if (sizeof(U) <= 4) {
+        return ctz32(static_cast<uint32_t>(x));
+    }
+    uint64_t low = static_cast<uint64_t>(x);
+    if (sizeof(U) <= 8 || low != 0) {
+        return ctz64(low);
+    }
+    return 64 + ctz64(static_cast<uint64_t>(x >> (sizeof(U) * 4)));
+}
+
+// НОД по Штейну: вместо деления с остатком - вычитание и сдвиги на ctz.
+// Разность и минимум считаются без ветвлений, поэтому цикл не страдает
+// от ошибок предсказания переходов.
+template <typename U>
+U binaryGcd(U u, U v) {
+    if (u == 0) {
+        return v;
+    }
+    if (v == 0) {
+        return u;
+    }
+    int uz = countTrailingZeros(u);
+    int vz = countTrailingZeros(v);
+    int shift = uz < vz ? uz : vz;
+    v >>= vz;
+    while (u != 0) {
+        u >>= uz;
+        // Для 128 бит: как только оба значения умещаются в 64 бита,
+        // продолжение идет на одиночных регистрах
+        if (sizeof(U) > 8 && ((u | v) >> (sizeof(U) * 4)) == 0) {
+            return static_cast<U>(binaryGcd(static_cast<uint64_t>(u), static_cast<uint64_t>(v))) << shift;
+        }
+        // |u - v| через маску знака: сравнение не превращается в переход
+        U mask = U(0) - static_cast<U>(u < v);
+        U diff = ((u - v) ^ mask) - mask;
+        v = u < v ? u : v;
+        u = diff;
+        if (u == 0) {
+            break;
+        }
+        uz = countTrailingZeros(u);
+    }
+    return v << shift;
+}
+
+// Арифметика с проверкой переполнения. Допустимы значения [-max, max]:
+// без минимального значения модуль и смена знака всегда представимы.
+template <typename Int>
+constexpr Int maxValue() {
+    typedef typename MakeUnsigned<Int>::type Unsigned;
+    return static_cast<Int>(static_cast<Unsigned>(~Unsigned(0)) >> 1);
+}
+
+inline void throwOverflow() {
+    throw std::overflow_error("Fraction overflow");
+}
+
+// Произведение и сумма без исключений: false, если результат вне диапазона
+template <typename Int>
+bool tryMul(Int a, Int b, Int& result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(a, b, &result) && result >= -maxValue<Int>();
+#else
+    Int absA = a < 0 ? -a : a;
+    Int absB = b < 0 ? -b : b;
+    if (absA != 0 && absB > maxValue<Int>() / absA) {
+        return false;
+    }
+    result = a * b;
+    return true;
+#endif
+}
+
+template <typename Int>
+bool tryAdd(Int a, Int b, Int& result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_add_overflow(a, b, &result) && result >= -maxValue<Int>();
+#else
+    if ((b > 0 && a > maxValue<Int>() - b) || (b < 0 && a < -maxValue<Int>() - b)) {
+        return false;
+    }
+    result = a + b;
+    return true;
+#endif
+}
+
+template <typename Int>
+Int checkedMul(Int a, Int b) {
+    Int result;
+    if (!tryMul(a, b, result)) {
+        throwOverflow();
+    }
+    return result;
+}
+
+template <typename Int>
+Int checkedAdd(Int a, Int b) {
+    Int result;
+    if (!tryAdd(a, b, result)) {
+        throwOverflow();
+    }
+    return result;
+}
+
+// Те же проверки для вычислений при компиляции: встроенные функции
+// переполнения constexpr не во всех компиляторах
+template <typename Int>
+constexpr Int constMul(Int a, Int b) {
+    Int absA = a < 0 ? -a : a;
+    Int absB = b < 0 ? -b : b;
+    if (absA != 0 && absB > maxValue<Int>() / absA) {
+        throwOverflow();
+    }
+    return a * b;
+}
+
+template <typename Int>
+constexpr Int constAdd(Int a, Int b) {
+    if ((b > 0 && a > maxValue<Int>() - b) || (b < 0 && a < -maxValue<Int>() - b)) {
+        throwOverflow();
+    }
+    return a + b;
+}
+
+// НОД модулей двух допустимых значений; результат помещается в Int
+template <typename Int>
+Int gcdOfValues(Int n, Int m) {
+    typedef typename MakeUnsigned<Int>::type Unsigned;
+    Unsigned a = static_cast<Unsigned>(n < 0 ? -n : n);
+    Unsigned b = static_cast<Unsigned>(m < 0 ? -m : m);
+    return static_cast<Int>(binaryGcd(a, b));
+}
+
+// Тип для промежуточной суммы при сложении: числитель до сокращения
+// может не поместиться в Int, даже если результат помещается.
+// Для __int128 более широкого типа нет, и проверяется сама сумма.
+template <typename Int>
+struct WiderInt {
+    typedef Int type;
+};
+
+template <>
+struct WiderInt<int32_t> {
+    typedef int64_t type;
+};
+
+#ifdef FRACTION_HAS_INT128
+template <>
+struct WiderInt<int64_t> {
+    typedef __int128 type;
+};
+#endif
+
+template <typename Int, typename Wide>
+constexpr Int checkedNarrow(Wide value) {
+    if (value > static_cast<Wide>(maxValue<Int>()) || value < -static_cast<Wide>(maxValue<Int>())) {
+        throwOverflow();
+    }
+    return static_cast<Int>(value);
+}
+
+// Разбор десятичной записи [+-]digits[.digits][(e|E)[+-]digits] в точную
+// дробь num / den, где den - степень десяти. Возвращает указатель за
+// разобранной записью или nullptr, если цифр нет. Нули в конце дробной
+// части не увеличивают den. При truncate лишние дробные цифры, которые не
+// помещаются в Acc, отбрасываются; иначе переполнение дает overflow_error.
+template <typename Acc>
+const char* parseDecimal(const char* p, const char* last, Acc& num, Acc& den, bool truncate = false) {
+    bool negative = false;
+    if (p != last && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    Acc value = 0;
+    Acc power = 1;
+    bool digits = false;
+    for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+        value = checkedAdd(checkedMul(value, Acc(10)), Acc(*p - '0'));
+        digits = true;
+    }
+
+    if (p != last && *p == '.') {
+        ++p;
+        int pendingZeros = 0;
+        bool full = false;
+        for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+            digits = true;
+            if (full) {
+                continue;
+            }
+            if (*p == '0') {
+                ++pendingZeros;
+                continue;
+            }
+            // Отложенные нули и новая цифра добавляются вместе
+            Acc nextValue = value;
+            Acc nextPower = power;
+            bool fits = true;
+            for (int k = 0; k <= pendingZeros && fits; ++k) {
+                fits = tryMul(nextValue, Acc(10), nextValue) && tryMul(nextPower, Acc(10), nextPower);
+            }
+            fits = fits && tryAdd(nextValue, Acc(*p - '0'), nextValue);
+            if (!fits) {
+                if (!truncate) {
+                    throwOverflow();
+                }
+                full = true;
+                continue;
+            }
+            value = nextValue;
+            power = nextPower;
+            pendingZeros = 0;
+        }
+    }
+    if (!digits) {
+        return nullptr;
+    }
+
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q != last && (*q == '+' || *q == '-')) {
+            negativeExponent = *q == '-';
+            ++q;
+        }
+        if (q != last && *q >= '0' && *q <= '9') {
+            int exponent = 0;
+            for (; q != last && *q >= '0' && *q <= '9'; ++q) {
+                exponent = std::min(exponent * 10 + (*q - '0'), 100000);
+            }
+            p = q;
+            // Нуль при любом порядке остается нулем; без этой проверки
+            // отрицательный порядок переполнял бы знаменатель
+            for (; exponent > 0 && value != 0; --exponent) {
+                if (!negativeExponent) {
+                    if (power > 1) {
+                        power /= 10;
+                    }
+                    else {
+                        value = checkedMul(value, Acc(10));
+                    }
+                }
+                else if (!tryMul(power, Acc(10), power)) {
+                    if (!truncate) {
+                        throwOverflow();
+                    }
+                    value /= 10;
+                }
+            }
+        }
+    }
+
+    num = negative ? -value : value;
+    den = power;
+    return p;
+}
+
+// Лучшее приближение num / den дробью со знаменателем не больше
+// maxDenominator: подходящие дроби цепной дроби, а на последнем шаге -
+// промежуточная дробь (t * h1 + h0) / (t * k1 + k0), если она ближе.
+// Результат записывается в num и den.
+template <typename Acc>
+void bestApproximation(Acc& num, Acc& den, Acc maxDenominator) {
+    if (maxDenominator < 1) {
+        throw std::invalid_argument("Maximum denominator must be positive");
+    }
+    bool negative = num < 0;
+    Acc p = negative ? -num : num;
+    Acc q = den;
+
+    Acc h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+    while (true) {
+        Acc a = p / q;
+        if (k1 != 0 && a > (maxDenominator - k0) / k1) {
+            Acc t = (maxDenominator - k0) / k1;
+            Acc semiNum = checkedAdd(checkedMul(t, h1), h0);
+            Acc semiDen = t * k1 + k0;
+            // Промежуточная дробь ближе, если p / q < 2t + k0 / k1; при 2t != a
+            // это решает целая часть, иначе сравнивается остаток: rem / q < k0 / k1
+            bool semiBetter = 2 * t > a;
+            if (2 * t == a) {
+                Acc rem = p - a * q;
+                Acc left, right;
+                if (tryMul(rem, k1, left) && tryMul(k0, q, right)) {
+                    semiBetter = left < right;
+                }
+                else {
+                    semiBetter = static_cast<long double>(rem) / static_cast<long double>(q) <
+                        static_cast<long double>(k0) / static_cast<long double>(k1);
+                }
+            }
+            if (semiBetter) {
+                h1 = semiNum;
+                k1 = semiDen;
+            }
+            break;
+        }
+        Acc h2 = checkedAdd(checkedMul(a, h1), h0);
+        Acc k2 = a * k1 + k0;
+        h0 = h1;
+        h1 = h2;
+        k0 = k1;
+        k1 = k2;
+
+        Acc r = p - a * q;
+        p = q;
+        q = r;
+        if (q == 0) {
+            break;
+        }
+    }
+
+    num = negative ? -h1 : h1;
+    den = k1;
+}
+
+// Точное значение double в виде num / 2^k. Слишком мелкие двоичные
+// разряды отбрасываются, чтобы знаменатель поместился в Acc.
+template <typename Acc>
+void doubleToRational(double value, Acc& num, Acc& den) {
+    if (!std::isfinite(value)) {
+        throw std::invalid_argument("Value is not finite");
+    }
+    int exponent;
+    double mantissa = std::frexp(std::fabs(value), &exponent);
+    Acc m = static_cast<Acc>(std::ldexp(mantissa, 53));
+    exponent -= 53;
+
+    const int maxShift = static_cast<int>(sizeof(Acc) * 8) - 2;
+    if (exponent < -maxShift) {
+        int drop = -maxShift - exponent;
+        m = drop < 64 ? m >> drop : 0;
+        exponent = -maxShift;
+    }
+    den = 1;
+    if (exponent < 0) {
+        den <<= -exponent;
+    }
+    else {
+        for (; exponent > 0; --exponent) {
+            m = checkedMul(m, Acc(2));
+        }
+    }
+    num = value < 0 ? -m : m;
+}
+
+// Дробь для вычислений при компиляции: литеральный тип без счетчика
+// экземпляров, все операции constexpr. Выражение из констант сворачивается
+// в одну сокращенную дробь; ноль в знаменателе или переполнение в
+// константном выражении дают ошибку компиляции, а при вычислении во время
+// выполнения - те же исключения, что у BasicFraction. НОД считается
+// алгоритмом Евклида: встроенные функции для ctz не constexpr.
+template <typename Int>
+class BasicConstFraction {
+private:
+    typedef typename WiderInt<Int>::type Wide;
+
+    Int numerator;
+    Int denominator;
+
+    struct Reduced {};
+
+    constexpr BasicConstFraction(Int num, Int denom, Reduced) : numerator(num), denominator(denom) {}
+
+public:
+    constexpr BasicConstFraction(Int num = 0, Int denom = 1) : numerator(num), denominator(denom) {
+        if (denom == 0) {
+            throw std::invalid_argument("Denominator cannot be zero");
+        }
+        if (num < -maxValue<Int>() || denom < -maxValue<Int>()) {
+            throwOverflow();
+        }
+        reduce();
+    }
+
+    template <typename T>
+    static constexpr T gcd(T n, T m) {
+        n = n < 0 ? -n : n;
+        m = m < 0 ? -m : m;
+        while (m != 0) {
+            T rest = n % m;
+            n = m;
+            m = rest;
+        }
+        return n;
+    }
+
+    constexpr void reduce() {
+        Int divisor = gcd(numerator, denominator);
+        if (divisor != 0) {
+            numerator /= divisor;
+            denominator /= divisor;
+        }
+        if (denominator < 0) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+    }
+
+    // Те же формулы, что в BasicFraction: сокращение до умножения и
+    // промежуточный числитель суммы в более широком типе
+    constexpr BasicConstFraction operator+(const BasicConstFraction& other) const {
+        Int g = gcd(denominator, other.denominator);
+        Wide t = constAdd(constMul<Wide>(numerator, other.denominator / g), constMul<Wide>(other.numerator, denominator / g));
+        Int g2 = g == 1 ? 1 : static_cast<Int>(gcd<Wide>(t, g));
+        return BasicConstFraction(checkedNarrow<Int>(t / g2), constMul(denominator / g, other.denominator / g2), Reduced());
+    }
+
+    constexpr BasicConstFraction operator-(const BasicConstFraction& other) const {
+        return *this + BasicConstFraction(-other.numerator, other.denominator, Reduced());
+    }
+
+    constexpr BasicConstFraction operator-() const {
+        return BasicConstFraction(-numerator, denominator, Reduced());
+    }
+
+    constexpr BasicConstFraction operator*(const BasicConstFraction& other) const {
+        if (numerator == 0 || other.numerator == 0) {
+            return BasicConstFraction(0, 1, Reduced());
+        }
+        Int g1 = gcd(numerator, other.denominator);
+        Int g2 = gcd(other.numerator, denominator);
+        return BasicConstFraction(constMul(numerator / g1, other.numerator / g2),
+            constMul(denominator / g2, other.denominator / g1), Reduced());
+    }
+
+    constexpr BasicConstFraction operator/(const BasicConstFraction& other) const {
+        if (other.numerator == 0) {
+            throw std::invalid_argument("Division by zero");
+        }
+        return *this * BasicConstFraction(other.denominator, other.numerator);
+    }
+
+    constexpr Int getNumerator() const {
+        return numerator;
+    }
+
+    constexpr Int getDenominator() const {
+        return denominator;
+    }
+};
+
+typedef BasicConstFraction<int32_t> ConstFraction;
+typedef BasicConstFraction<int64_t> ConstFraction64;
+
+// Подсчет живых экземпляров. Каждый поток считает в своем счетчике
+// (thread_local), поэтому конструкторы в разных потоках не гоняют одну
+// строку кэша между ядрами и не требуют атомарных инструкций с блокировкой.
+// Счетчики потоков зарегистрированы в общем списке; total() складывает их
+// под мьютексом, а счетчик завершившегося потока переносится в retired.
+// Объект может быть создан в одном потоке и уничтожен в другом: по
+// отдельности счетчики тогда неверны, но сумма точна.
+template <typename Tag>
+class InstanceCounter {
+private:
+    struct Shard;
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<Shard*> shards;
+        long long retired = 0;
+    };
+
+    struct Shard {
+        std::atomic<long long> count;
+
+        Shard() : count(0) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.shards.push_back(this);
+        }
+
+        ~Shard() {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.retired += count.load(std::memory_order_relaxed);
+            reg.shards.erase(std::find(reg.shards.begin(), reg.shards.end(), this));
+        }
+    };
+
+    static Registry& registry() {
+        static Registry reg;
+        return reg;
+    }
+
+    static Shard& local() {
+        static thread_local Shard shard;
+        return shard;
+    }
+
+public:
+    // Пишет только поток-владелец, поэтому хватает обычных load и store;
+    // atomic нужен лишь для чтения из total() без гонки данных
+    static void add(long long delta) {
+        Shard& shard = local();
+        shard.count.store(shard.count.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    static long long total() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        long long sum = reg.retired;
+        for (const Shard* shard : reg.shards) {
+            sum += shard->count.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+};
+
+// Подсчет отключен: вызовы исчезают при компиляции
+struct NoInstanceCounter {
+    static void add(long long) {}
+
+    static long long total() {
+        return 0;
+    }
+};
+
+// Подсчет экземпляров по умолчанию; -DFRACTION_COUNT_INSTANCES=0 отключает
+// его для всех дробей, BasicFraction<Int, false> - для отдельного типа
+#ifndef FRACTION_COUNT_INSTANCES
+#define FRACTION_COUNT_INSTANCES 1
+#endif
+
+// Дробь над целым типом Int (int32_t, int64_t, __int128). Дробь всегда
+// хранится несократимой со знаменателем больше нуля. Операции сокращают
+// множители до умножения, поэтому промежуточные значения не больше
+// результата, а переполнение результата дает std::overflow_error.
+template <typename Int, bool Counted = FRACTION_COUNT_INSTANCES != 0>
+class BasicFraction {
 private:
-    int numerator;
-    int denominator;
-    static int instance_count;
+    typedef typename MakeUnsigned<Int>::type Unsigned;
+    typedef typename std::conditional<Counted, InstanceCounter<BasicFraction>, NoInstanceCounter>::type Counter;
+
+    Int numerator;
+    Int denominator;
+
+    // Метка для конструктора из уже сокращенных значений
+    struct Reduced {};
+
+    BasicFraction(Int num, Int denom, Reduced) : numerator(num), denominator(denom) {
+        Counter::add(1);
+    }
+
+    static Unsigned magnitude(Int value) {
+        return static_cast<Unsigned>(value < 0 ? -value : value);
+    }
+
+    static Int gcdOf(Int n, Int m) {
+        return gcdOfValues(n, m);
+    }
 
     void normalize() {
         if (denominator < 0) {
@@ -17,90 +624,1306 @@ private:
     }
 
 public:
-    Fraction(int num = 0, int denom = 1) : numerator(num), denominator(denom) {
+    BasicFraction(Int num = 0, Int denom = 1) : numerator(num), denominator(denom) {
         if (denom == 0) {
             throw std::invalid_argument("Denominator cannot be zero");
         }
+        if (num < -maxValue<Int>() || denom < -maxValue<Int>()) {
+            throwOverflow();
+        }
         reduce();
-        ++instance_count;
+        Counter::add(1);
     }
 
-    ~Fraction() {
-        --instance_count;
+    // Значение, вычисленное при компиляции, уже сокращено
+    BasicFraction(const BasicConstFraction<Int>& value)
+        : numerator(value.getNumerator()), denominator(value.getDenominator()) {
+        Counter::add(1);
     }
 
-    static int gcd(int n, int m) {
-        n = std::abs(n);
-        m = std::abs(m);
-        while (m != 0) {
-            int temp = m;
-            m = n % m;
-            n = temp;
+    BasicFraction(const BasicFraction& other) : numerator(other.numerator), denominator(other.denominator) {
+        Counter::add(1);
+    }
+
+    BasicFraction& operator=(const BasicFraction& other) = default;
+
+    ~BasicFraction() {
+        Counter::add(-1);
+    }
+
+    static Int gcd(Int n, Int m) {
+        if (n < -maxValue<Int>() || m < -maxValue<Int>()) {
+            throwOverflow();
         }
-        return n;
+        return gcdOf(n, m);
     }
 
     void reduce() {
-        int divisor = gcd(numerator, denominator);
+        Int divisor = gcdOf(numerator, denominator);
         numerator /= divisor;
         denominator /= divisor;
         normalize();
     }
 
-    Fraction operator+(const Fraction& other) const {
-        int num = numerator * other.denominator + other.numerator * denominator;
-        int denom = denominator * other.denominator;
-        return Fraction(num, denom);
+    // a/b + c/d при g = gcd(b, d): числитель t = a*(d/g) + c*(b/g) и знаменатель
+    // (b/g)*d сокращаются еще только на gcd(t, g) (Кнут, 4.5.1)
+    BasicFraction operator+(const BasicFraction& other) const {
+        typedef typename WiderInt<Int>::type Wide;
+        Int g = gcdOf(denominator, other.denominator);
+        Wide t = checkedAdd(checkedMul<Wide>(numerator, other.denominator / g), checkedMul<Wide>(other.numerator, denominator / g));
+        Int g2 = g == 1 ? 1 : static_cast<Int>(gcdOfValues<Wide>(t, g));
+        Int num = checkedNarrow<Int>(t / g2);
+        return BasicFraction(num, checkedMul(denominator / g, other.denominator / g2), Reduced());
     }
 
-    Fraction operator-(const Fraction& other) const {
-        int num = numerator * other.denominator - other.numerator * denominator;
-        int denom = denominator * other.denominator;
-        return Fraction(num, denom);
+    BasicFraction operator-(const BasicFraction& other) const {
+        return *this + BasicFraction(-other.numerator, other.denominator, Reduced());
     }
 
-    Fraction operator*(const Fraction& other) const {
-        int num = numerator * other.numerator;
-        int denom = denominator * other.denominator;
-        return Fraction(num, denom);
+    // Перекрестное сокращение: (a/b) * (c/d) = (a/g1 * c/g2) / (b/g2 * d/g1),
+    // где g1 = gcd(a, d), g2 = gcd(c, b); результат уже несократим
+    BasicFraction operator*(const BasicFraction& other) const {
+        if (numerator == 0 || other.numerator == 0) {
+            return BasicFraction(0, 1, Reduced());
+        }
+        Int g1 = gcdOf(numerator, other.denominator);
+        Int g2 = gcdOf(other.numerator, denominator);
+        Int num = checkedMul(numerator / g1, other.numerator / g2);
+        Int denom = checkedMul(denominator / g2, other.denominator / g1);
+        return BasicFraction(num, denom, Reduced());
     }
 
-    Fraction operator/(const Fraction& other) const {
+    BasicFraction operator/(const BasicFraction& other) const {
         if (other.numerator == 0) {
             throw std::invalid_argument("Division by zero");
         }
-        int num = numerator * other.denominator;
-        int denom = denominator * other.numerator;
-        return Fraction(num, denom);
+        if (numerator == 0) {
+            return BasicFraction(0, 1, Reduced());
+        }
+        Int g1 = gcdOf(numerator, other.numerator);
+        Int g2 = gcdOf(other.denominator, denominator);
+        Int num = checkedMul(numerator / g1, other.denominator / g2);
+        Int denom = checkedMul(denominator / g2, other.numerator / g1);
+        BasicFraction result(num, denom, Reduced());
+        result.normalize();
+        return result;
+    }
+
+    // Точное значение десятичной записи, например "-12.375" или "1.5e-3".
+    // Разбор идет в более широком типе: степень десяти в знаменателе может
+    // не поместиться в Int, хотя сокращенная дробь помещается.
+    static BasicFraction fromDecimal(const char* text) {
+        typedef typename WiderInt<Int>::type Wide;
+        Wide num, den;
+        const char* last = text + std::strlen(text);
+        if (parseDecimal(text, last, num, den) != last) {
+            throw std::invalid_argument(std::string("Invalid decimal: ") + text);
+        }
+        Wide g = gcdOfValues(num, den);
+        return BasicFraction(checkedNarrow<Int>(num / g), checkedNarrow<Int>(den / g), Reduced());
+    }
+
+    // Ближайшая к десятичной записи дробь со знаменателем не больше maxDenominator
+    static BasicFraction fromDecimal(const char* text, Int maxDenominator) {
+        typedef typename WiderInt<Int>::type Wide;
+        Wide num, den;
+        const char* last = text + std::strlen(text);
+        if (parseDecimal(text, last, num, den, true) != last) {
+            throw std::invalid_argument(std::string("Invalid decimal: ") + text);
+        }
+        bestApproximation<Wide>(num, den, maxDenominator);
+        return BasicFraction(checkedNarrow<Int>(num), checkedNarrow<Int>(den));
+    }
+
+    // Ближайшая к value дробь со знаменателем не больше maxDenominator.
+    // Для выбора между соседними дробями нужна точность порядка
+    // 1 / maxDenominator^2, поэтому double переводится в тип на две ступени шире.
+    static BasicFraction approximate(double value, Int maxDenominator) {
+        typedef typename WiderInt<typename WiderInt<Int>::type>::type Wide;
+        Wide num, den;
+        doubleToRational(value, num, den);
+        bestApproximation<Wide>(num, den, maxDenominator);
+        return BasicFraction(checkedNarrow<Int>(num), checkedNarrow<Int>(den));
     }
 
     static void printAsFraction(double decimal_fraction) {
-        const int precision = 1000000; // Precision for conversion
-        int denom = precision;
-        int num = static_cast<int>(std::round(decimal_fraction * precision));
-        Fraction frac(num, denom);
-        frac.reduce();
-        std::cout << frac << std::endl;
+        const Int precision = 1000000; // Наибольший знаменатель
+        std::cout << approximate(decimal_fraction, precision) << std::endl;
     }
 
+    // Строка выводится точно, а если точная дробь не помещается в Int - приближенно
     static void printAsFraction(const char* decimal_fraction) {
-        double value = std::stod(decimal_fraction);
-        printAsFraction(value);
+        const Int precision = 1000000;
+        try {
+            std::cout << fromDecimal(decimal_fraction) << std::endl;
+        }
+        catch (const std::overflow_error&) {
+            std::cout << fromDecimal(decimal_fraction, precision) << std::endl;
+        }
     }
 
+    // Число живых экземпляров во всех потоках; 0, если подсчет отключен
     static int getInstanceCount() {
-        return instance_count;
+        return static_cast<int>(Counter::total());
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Fraction& fraction) {
-        os << fraction.numerator << "/" << fraction.denominator;
+    Int getNumerator() const {
+        return numerator;
+    }
+
+    Int getDenominator() const {
+        return denominator;
+    }
+
+    // Вывод цифрами: у std::ostream нет оператора для __int128
+    friend std::ostream& operator<<(std::ostream& os, const BasicFraction& fraction) {
+        auto write = [&os](Int value) {
+            char digits[48];
+            char* end = digits + sizeof(digits);
+            char* p = end;
+            Unsigned rest = magnitude(value);
+            do {
+                *--p = static_cast<char>('0' + static_cast<int>(rest % 10));
+                rest /= 10;
+            } while (rest != 0);
+            if (value < 0) {
+                *--p = '-';
+            }
+            os.write(p, end - p);
+        };
+        write(fraction.numerator);
+        os << "/";
+        write(fraction.denominator);
         return os;
     }
 };
 
-int Fraction::instance_count = 0;
+typedef BasicFraction<int32_t> Fraction;
+typedef BasicFraction<int64_t> Fraction64;
+#ifdef FRACTION_HAS_INT128
+typedef BasicFraction<__int128> Fraction128;
+#endif
+
+// Константа слева от дроби времени выполнения; справа она преобразуется
+// в BasicFraction неявно
+template <typename Int, bool Counted>
+BasicFraction<Int, Counted> operator+(const BasicConstFraction<Int>& a, const BasicFraction<Int, Counted>& b) {
+    return BasicFraction<Int, Counted>(a) + b;
+}
+
+template <typename Int, bool Counted>
+BasicFraction<Int, Counted> operator-(const BasicConstFraction<Int>& a, const BasicFraction<Int, Counted>& b) {
+    return BasicFraction<Int, Counted>(a) - b;
+}
+
+template <typename Int, bool Counted>
+BasicFraction<Int, Counted> operator*(const BasicConstFraction<Int>& a, const BasicFraction<Int, Counted>& b) {
+    return BasicFraction<Int, Counted>(a) * b;
+}
+
+template <typename Int, bool Counted>
+BasicFraction<Int, Counted> operator/(const BasicConstFraction<Int>& a, const BasicFraction<Int, Counted>& b) {
+    return BasicFraction<Int, Counted>(a) / b;
+}
+
+// Вывод константы так же, как дроби
+template <typename Int>
+std::ostream& operator<<(std::ostream& os, const BasicConstFraction<Int>& fraction) {
+    return os << BasicFraction<Int, false>(fraction);
+}
+
+// Сумма последовательности дробей без сокращения на каждом шаге.
+// Знаменатель суммы - НОК знаменателей слагаемых. Пока он не меняется,
+// множители для недавних знаменателей хранятся в маленькой таблице, и
+// слагаемое добавляется одним умножением и сложением без НОД.
+// Числитель и знаменатель сокращаются, только когда очередной шаг не
+// помещается в тип Acc, и в конце.
+template <typename Int, typename Acc = typename WiderInt<Int>::type>
+class FractionAccumulator {
+private:
+    static const size_t FACTOR_SLOTS = 16;
+
+    struct FactorSlot {
+        Acc denominator; // 0 - пустая ячейка
+        Acc factor;      // Общий знаменатель / denominator
+    };
+
+    Acc numerator;
+    Acc denominator;
+    FactorSlot factors[FACTOR_SLOTS];
+
+    void setDenominator(Acc value) {
+        denominator = value;
+        for (FactorSlot& slot : factors) {
+            slot.denominator = 0;
+        }
+    }
+
+    // Один шаг сложения n/d; false, если промежуточные значения не помещаются
+    bool tryAddTerm(Acc n, Acc d) {
+        FactorSlot& slot = factors[static_cast<size_t>(d) % FACTOR_SLOTS];
+        Acc term, sum;
+        if (slot.denominator == d) {
+            if (!tryMul(n, slot.factor, term) || !tryAdd(numerator, term, sum)) {
+                return false;
+            }
+            numerator = sum;
+            return true;
+        }
+
+        Acc g = gcdOfValues(denominator, d);
+        Acc scale = d / g;
+        Acc factor = denominator / g;
+        Acc lcm;
+        if (!tryMul(denominator, scale, lcm) || !tryMul(numerator, scale, sum) ||
+            !tryMul(n, factor, term) || !tryAdd(sum, term, sum)) {
+            return false;
+        }
+        numerator = sum;
+        if (scale != 1) {
+            setDenominator(lcm);
+        }
+        FactorSlot& target = factors[static_cast<size_t>(d) % FACTOR_SLOTS];
+        target.denominator = d;
+        target.factor = factor;
+        return true;
+    }
+
+    // Сокращение накопленной суммы
+    void reduce() {
+        Acc g = gcdOfValues(numerator, denominator);
+        numerator /= g;
+        setDenominator(denominator / g);
+    }
+
+public:
+    FractionAccumulator() : numerator(0), denominator(1), factors() {}
+
+    // Слагаемое n/d со знаменателем больше нуля
+    void add(Int n, Int d) {
+        if (d <= 0) {
+            throw std::invalid_argument("Denominator must be positive");
+        }
+        if (!tryAddTerm(n, d)) {
+            reduce();
+            if (!tryAddTerm(n, d)) {
+                throwOverflow();
+            }
+        }
+    }
+
+    void add(const BasicFraction<Int>& fraction) {
+        add(fraction.getNumerator(), fraction.getDenominator());
+    }
+
+    // Добавление суммы другого накопителя
+    void merge(const FractionAccumulator& other) {
+        FractionAccumulator part = other;
+        part.reduce();
+        Acc n = part.numerator;
+        Acc d = part.denominator;
+        if (!tryAddTerm(n, d)) {
+            reduce();
+            if (!tryAddTerm(n, d)) {
+                throwOverflow();
+            }
+        }
+    }
+
+    // Несократимая сумма; std::overflow_error, если она не помещается в Int
+    BasicFraction<Int> result() const {
+        Acc g = gcdOfValues(numerator, denominator);
+        return BasicFraction<Int>(checkedNarrow<Int>(numerator / g), checkedNarrow<Int>(denominator / g));
+    }
+};
+
+// Массив дробей в виде двух массивов: числителей и знаменателей.
+// Дроби не сокращаются при добавлении; сокращенное значение дает operator[].
+template <typename Int>
+class FractionArray {
+private:
+    std::vector<Int> numerators;
+    std::vector<Int> denominators;
+
+public:
+    // Начиная с этого размера сумма делится между потоками
+    static const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+    void push_back(Int num, Int denom) {
+        if (denom == 0) {
+            throw std::invalid_argument("Denominator cannot be zero");
+        }
+        if (num < -maxValue<Int>() || denom < -maxValue<Int>()) {
+            throwOverflow();
+        }
+        numerators.push_back(denom < 0 ? -num : num);
+        denominators.push_back(denom < 0 ? -denom : denom);
+    }
+
+    void push_back(const BasicFraction<Int>& fraction) {
+        numerators.push_back(fraction.getNumerator());
+        denominators.push_back(fraction.getDenominator());
+    }
+
+    void reserve(size_t count) {
+        numerators.reserve(count);
+        denominators.reserve(count);
+    }
+
+    void append(const FractionArray& other) {
+        numerators.insert(numerators.end(), other.numerators.begin(), other.numerators.end());
+        denominators.insert(denominators.end(), other.denominators.begin(), other.denominators.end());
+    }
+
+    size_t size() const {
+        return numerators.size();
+    }
+
+    BasicFraction<Int> operator[](size_t index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return BasicFraction<Int>(numerators[index], denominators[index]);
+    }
+
+    const Int* getNumerators() const {
+        return numerators.data();
+    }
+
+    const Int* getDenominators() const {
+        return denominators.data();
+    }
+
+    // Сумма элементов [begin, end) в накопителе
+    template <typename Acc>
+    void accumulate(FractionAccumulator<Int, Acc>& acc, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end; ++i) {
+            acc.add(numerators[i], denominators[i]);
+        }
+    }
+
+    // Сумма всех элементов. Каждый поток суммирует свой участок, затем
+    // частичные суммы попарно сливаются деревом: на уровне level поток
+    // добавляет сумму участка i + level к участку i.
+    BasicFraction<Int> sum(unsigned threads = 0) const {
+        typedef FractionAccumulator<Int> Accumulator;
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (size() < PARALLEL_THRESHOLD) {
+            threads = 1;
+        }
+
+        std::vector<Accumulator> partial(threads);
+        std::vector<std::exception_ptr> errors(threads);
+        size_t step = (size() + threads - 1) / threads;
+        // Исключение потока t сохраняется в errors[t] и пробрасывается после join
+        auto guarded = [&errors](size_t t, auto work) {
+            try {
+                work();
+            }
+            catch (...) {
+                errors[t] = std::current_exception();
+            }
+        };
+        auto runAll = [&errors](std::vector<std::thread>& pool) {
+            for (std::thread& th : pool) {
+                th.join();
+            }
+            pool.clear();
+            for (std::exception_ptr& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back([this, &partial, &guarded, t, step]() {
+                guarded(t, [this, &partial, t, step]() {
+                    accumulate(partial[t], std::min(size(), t * step), std::min(size(), (t + 1) * step));
+                });
+            });
+        }
+        guarded(0, [this, &partial, step]() {
+            accumulate(partial[0], 0, std::min(size(), step));
+        });
+        runAll(pool);
+
+        for (size_t level = 1; level < threads; level *= 2) {
+            for (size_t i = 2 * level; i + level < threads; i += 2 * level) {
+                pool.emplace_back([&partial, &guarded, i, level]() {
+                    guarded(i, [&partial, i, level]() {
+                        partial[i].merge(partial[i + level]);
+                    });
+                });
+            }
+            guarded(0, [&partial, level]() {
+                partial[0].merge(partial[level]);
+            });
+            runAll(pool);
+        }
+        return partial[0].result();
+    }
+};
+
+// Разделители чисел в массовом разборе
+inline bool isDecimalSeparator(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ';';
+}
+
+// Разбор всех десятичных чисел из буфера в точные дроби. Буфер делится на
+// участки по числу потоков, границы сдвигаются до ближайшего разделителя,
+// и каждый поток разбирает свой участок; результаты склеиваются по порядку.
+// Дроби не сокращаются: знаменатели остаются степенями десяти.
+template <typename Int>
+FractionArray<Int> parseDecimals(const char* data, size_t size, unsigned threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t minChunk = 1 << 16;
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, size / minChunk)));
+
+    std::vector<size_t> bounds(threads + 1, size);
+    bounds[0] = 0;
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t pos = std::max(bounds[t - 1], size / threads * t);
+        while (pos < size && !isDecimalSeparator(data[pos])) {
+            ++pos;
+        }
+        bounds[t] = pos;
+    }
+
+    std::vector<FractionArray<Int>> parts(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    auto work = [&](unsigned t) {
+        try {
+            const char* p = data + bounds[t];
+            const char* last = data + bounds[t + 1];
+            FractionArray<Int>& out = parts[t];
+            out.reserve((bounds[t + 1] - bounds[t]) / 8);
+            while (true) {
+                while (p != last && isDecimalSeparator(*p)) {
+                    ++p;
+                }
+                if (p == last) {
+                    break;
+                }
+                Int num, den;
+                const char* end = parseDecimal(p, last, num, den);
+                if (end == nullptr || (end != last && !isDecimalSeparator(*end))) {
+                    throw std::invalid_argument("Invalid decimal at offset " + std::to_string(p - data));
+                }
+                out.push_back(num, den);
+                p = end;
+            }
+        }
+        catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    for (std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    if (threads == 1) {
+        return std::move(parts[0]);
+    }
+    size_t total = 0;
+    for (const FractionArray<Int>& part : parts) {
+        total += part.size();
+    }
+    FractionArray<Int> result;
+    result.reserve(total);
+    for (const FractionArray<Int>& part : parts) {
+        result.append(part);
+    }
+    return result;
+}
+
+// То же для содержимого файла
+template <typename Int>
+FractionArray<Int> parseDecimalFile(const std::string& path, unsigned threads = 0) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    in.seekg(0, std::ios::end);
+    std::vector<char> buffer(static_cast<size_t>(in.tellg()));
+    in.seekg(0, std::ios::beg);
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return parseDecimals<Int>(buffer.data(), buffer.size(), threads);
+}
+
+// Рациональная матрица: числители и знаменатели хранятся раздельно.
+// Определитель, обратная матрица и решение систем считаются без дробей
+// исключением Барейса: строки приводятся к общему знаменателю, и
+// элементы остаются целыми на всех шагах. Каждый элемент после шага k -
+// минор исходной матрицы, поэтому числа растут не быстрее определителя,
+// а НОД не нужен вовсе. Дроби строятся только из итоговых значений.
+template <typename Int>
+class RationalMatrix {
+private:
+    typedef typename WiderInt<Int>::type Wide;
+
+    size_t rows;
+    size_t cols;
+    std::vector<Int> numerators;
+    std::vector<Int> denominators;
+
+    // Результат исключения: целая матрица шириной width, знак перестановки
+    // строк, множители, на которые были умножены строки, и общие
+    // знаменатели дополнительных столбцов
+    struct Elimination {
+        std::vector<Int> data;
+        size_t width;
+        bool negative;
+        bool singular;
+        std::vector<Int> scales;
+        std::vector<Int> extraScales;
+    };
+
+    static Int lcmOf(Int a, Int b) {
+        return checkedMul(a / gcdOfValues(a, b), b);
+    }
+
+    // Выполнение fn(begin, end) по участкам [first, last) в threads потоках;
+    // исключение из любого потока передается вызывающему
+    template <typename Fn>
+    static void forRange(size_t first, size_t last, unsigned threads, Fn fn) {
+        size_t count = last - first;
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, count)));
+        if (threads == 1) {
+            fn(first, last);
+            return;
+        }
+        size_t step = (count + threads - 1) / threads;
+        std::vector<std::exception_ptr> errors(threads);
+        auto work = [&](unsigned t) {
+            try {
+                fn(std::min(last, first + t * step), std::min(last, first + (t + 1) * step));
+            }
+            catch (...) {
+                errors[t] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(work, t);
+        }
+        work(0);
+        for (std::thread& th : pool) {
+            th.join();
+        }
+        for (std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    static unsigned threadCount(unsigned threads) {
+        return threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Строки матрицы умножаются на НОК знаменателей строки, дополняются
+    // справа столбцами extra (extraCols штук, построчно), каждый из которых
+    // умножен на НОК своих знаменателей, и приводятся к верхнетреугольному
+    // виду. Знаменатели правых частей не входят в множители строк, иначе
+    // они накапливались бы в определителе целой матрицы. После шага k элемент (i, j) равен
+    // (a[k][k] * a[i][j] - a[i][k] * a[k][j]) / p, где p - предыдущая
+    // ведущая величина; деление всегда точное (тождество Сильвестра).
+    // Строки ниже ведущей обновляются независимо и делятся между потоками.
+    Elimination eliminate(const Int* extraNum, const Int* extraDen, size_t extraCols, unsigned threads) const {
+        threads = threadCount(threads);
+        const size_t n = rows;
+        Elimination result;
+        result.width = n + extraCols;
+        result.negative = false;
+        result.singular = false;
+        result.data.resize(n * result.width);
+        result.scales.assign(n, 1);
+        result.extraScales.assign(extraCols, 1);
+
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < extraCols; ++j) {
+                result.extraScales[j] = lcmOf(result.extraScales[j], extraDen[i * extraCols + j]);
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            Int scale = 1;
+            for (size_t j = 0; j < n; ++j) {
+                scale = lcmOf(scale, denominators[i * n + j]);
+            }
+            Int* row = &result.data[i * result.width];
+            for (size_t j = 0; j < n; ++j) {
+                row[j] = checkedMul(numerators[i * n + j], scale / denominators[i * n + j]);
+            }
+            for (size_t j = 0; j < extraCols; ++j) {
+                Int value = checkedMul(extraNum[i * extraCols + j], result.extraScales[j] / extraDen[i * extraCols + j]);
+                row[n + j] = checkedMul(value, scale);
+            }
+            result.scales[i] = scale;
+        }
+
+        const size_t width = result.width;
+        Int* a = result.data.data();
+        Int previous = 1;
+        for (size_t k = 0; k < n; ++k) {
+            // Ведущий элемент - первый ненулевой в столбце k
+            size_t pivot = k;
+            while (pivot < n && a[pivot * width + k] == 0) {
+                ++pivot;
+            }
+            if (pivot == n) {
+                result.singular = true;
+                return result;
+            }
+            if (pivot != k) {
+                std::swap_ranges(a + pivot * width, a + (pivot + 1) * width, a + k * width);
+                std::swap(result.scales[pivot], result.scales[k]);
+                result.negative = !result.negative;
+            }
+
+            const Int* top = a + k * width;
+            const Int diagonal = top[k];
+            auto update = [=](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    Int* row = a + i * width;
+                    const Int factor = row[k];
+                    for (size_t j = k + 1; j < width; ++j) {
+                        Wide value = checkedAdd(checkedMul<Wide>(diagonal, row[j]), checkedMul<Wide>(-factor, top[j]));
+                        row[j] = checkedNarrow<Int>(value / previous);
+                    }
+                    row[k] = 0;
+                }
+            };
+            size_t work = (n - k - 1) * (width - k - 1);
+            forRange(k + 1, n, work >= PARALLEL_THRESHOLD ? threads : 1, update);
+            previous = diagonal;
+        }
+        return result;
+    }
+
+    // Обратный ход для столбцов [n, width) треугольной матрицы: при
+    // D = a[n-1][n-1] величины X[i] = D * x[i] целые (правило Крамера),
+    // и a[i][i] * X[i] = D * b[i] - sum(a[i][j] * X[j]) делится нацело.
+    // Столбцы независимы и делятся между потоками. Результат - X по
+    // столбцам: X[c * n + i].
+    static std::vector<Int> backSubstitute(const Elimination& e, size_t n, unsigned threads) {
+        const size_t extraCols = e.width - n;
+        const Int* a = e.data.data();
+        const Int determinant = a[(n - 1) * e.width + n - 1];
+        std::vector<Int> solution(extraCols * n);
+        auto solve = [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                Int* x = &solution[c * n];
+                for (size_t i = n; i-- > 0;) {
+                    const Int* row = a + i * e.width;
+                    Wide value = checkedMul<Wide>(determinant, row[n + c]);
+                    for (size_t j = i + 1; j < n; ++j) {
+                        value = checkedAdd(value, checkedMul<Wide>(-row[j], x[j]));
+                    }
+                    x[i] = checkedNarrow<Int>(value / row[i]);
+                }
+            }
+        };
+        forRange(0, extraCols, extraCols * n * n >= PARALLEL_THRESHOLD ? threads : 1, solve);
+        return solution;
+    }
+
+    // value / scale, где scale - произведение множителей строк; деление
+    // идет по одному множителю, чтобы произведение не переполнилось
+    static BasicFraction<Int> unscale(BasicFraction<Int> value, const std::vector<Int>& scales) {
+        for (Int scale : scales) {
+            if (scale != 1) {
+                value = value / BasicFraction<Int>(scale);
+            }
+        }
+        return value;
+    }
+
+public:
+    // Начиная с этого числа обновлений элементов за шаг работа делится между потоками
+    static const size_t PARALLEL_THRESHOLD = 1 << 14;
+
+    RationalMatrix(size_t rows, size_t cols)
+        : rows(rows), cols(cols), numerators(rows * cols, 0), denominators(rows * cols, 1) {}
+
+    size_t getRows() const {
+        return rows;
+    }
+
+    size_t getCols() const {
+        return cols;
+    }
+
+    BasicFraction<Int> at(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        return BasicFraction<Int>(numerators[row * cols + col], denominators[row * cols + col]);
+    }
+
+    void setAt(size_t row, size_t col, const BasicFraction<Int>& value) {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Index out of range");
+        }
+        numerators[row * cols + col] = value.getNumerator();
+        denominators[row * cols + col] = value.getDenominator();
+    }
+
+    void setAt(size_t row, size_t col, Int num, Int denom = 1) {
+        setAt(row, col, BasicFraction<Int>(num, denom));
+    }
+
+    // det(A) = +-D / (произведение множителей строк)
+    BasicFraction<Int> determinant(unsigned threads = 0) const {
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix must be square");
+        }
+        if (rows == 0) {
+            return BasicFraction<Int>(1);
+        }
+        Elimination e = eliminate(nullptr, nullptr, 0, threads);
+        if (e.singular) {
+            return BasicFraction<Int>(0);
+        }
+        Int last = e.data[rows * rows - 1];
+        return unscale(BasicFraction<Int>(e.negative ? -last : last), e.scales);
+    }
+
+    // Решение A * x = b
+    std::vector<BasicFraction<Int>> solve(const std::vector<BasicFraction<Int>>& b, unsigned threads = 0) const {
+        if (b.size() != rows) {
+            throw std::invalid_argument("Size mismatch in linear system");
+        }
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix must be square");
+        }
+        std::vector<Int> num(rows), den(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            num[i] = b[i].getNumerator();
+            den[i] = b[i].getDenominator();
+        }
+        std::vector<BasicFraction<Int>> x;
+        if (rows == 0) {
+            return x;
+        }
+        Elimination e = eliminate(num.data(), den.data(), 1, threads);
+        if (e.singular) {
+            throw std::invalid_argument("Matrix is singular");
+        }
+        std::vector<Int> scaled = backSubstitute(e, rows, threadCount(threads));
+        Int determinant = e.data[rows * e.width - 2];
+        x.reserve(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            x.push_back(BasicFraction<Int>(scaled[i], determinant) / BasicFraction<Int>(e.extraScales[0]));
+        }
+        return x;
+    }
+
+    // Обратная матрица: A * X = E для всех столбцов единичной матрицы сразу
+    RationalMatrix inverse(unsigned threads = 0) const {
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix must be square");
+        }
+        const size_t n = rows;
+        RationalMatrix result(n, n);
+        if (n == 0) {
+            return result;
+        }
+        std::vector<Int> identity(n * n, 0), ones(n * n, 1);
+        for (size_t i = 0; i < n; ++i) {
+            identity[i * n + i] = 1;
+        }
+        Elimination e = eliminate(identity.data(), ones.data(), n, threads);
+        if (e.singular) {
+            throw std::invalid_argument("Matrix is singular");
+        }
+        std::vector<Int> scaled = backSubstitute(e, n, threadCount(threads));
+        Int determinant = e.data[(n - 1) * e.width + n - 1];
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                result.setAt(i, j, BasicFraction<Int>(scaled[j * n + i], determinant));
+            }
+        }
+        return result;
+    }
+
+    void print() const {
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                std::ostringstream text;
+                text << at(i, j);
+                std::cout << std::setw(10) << text.str();
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+
+// Прежняя реализация для сравнения: произведения без сокращения и
+// НОД Евклида после каждой операции
+struct NaiveFraction {
+    int64_t numerator;
+    int64_t denominator;
+
+    NaiveFraction(int64_t num, int64_t denom) : numerator(num), denominator(denom) {
+        int64_t a = num < 0 ? -num : num;
+        int64_t b = denom < 0 ? -denom : denom;
+        while (b != 0) {
+            int64_t temp = b;
+            b = a % b;
+            a = temp;
+        }
+        numerator /= a;
+        denominator /= a;
+        if (denominator < 0) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+    }
+
+    int64_t getNumerator() const {
+        return numerator;
+    }
+
+    int64_t getDenominator() const {
+        return denominator;
+    }
+
+    NaiveFraction operator+(const NaiveFraction& o) const {
+        return NaiveFraction(numerator * o.denominator + o.numerator * denominator, denominator * o.denominator);
+    }
+
+    NaiveFraction operator-(const NaiveFraction& o) const {
+        return NaiveFraction(numerator * o.denominator - o.numerator * denominator, denominator * o.denominator);
+    }
+
+    NaiveFraction operator*(const NaiveFraction& o) const {
+        return NaiveFraction(numerator * o.numerator, denominator * o.denominator);
+    }
+
+    NaiveFraction operator/(const NaiveFraction& o) const {
+        return NaiveFraction(numerator * o.denominator, denominator * o.numerator);
+    }
+};
+
+// Цепочка (a + b) * c / d - a над массивами случайных дробей с
+// двузначными числителями и знаменателями; время на одну цепочку в нс.
+// В 32 битах часть цепочек переполняется, прежняя реализация в 64 битах
+// этого не замечает.
+template <typename F, typename Int>
+double chainBenchmark(const std::vector<int>& values, long long& checksum, size_t& overflows) {
+    size_t count = values.size() / 8;
+    std::vector<F> a, b, c, d;
+    a.reserve(count);
+    b.reserve(count);
+    c.reserve(count);
+    d.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const int* v = &values[i * 8];
+        a.push_back(F(static_cast<Int>(v[0]), static_cast<Int>(v[1])));
+        b.push_back(F(static_cast<Int>(v[2]), static_cast<Int>(v[3])));
+        c.push_back(F(static_cast<Int>(v[4]), static_cast<Int>(v[5])));
+        d.push_back(F(static_cast<Int>(v[6]), static_cast<Int>(v[7])));
+    }
+
+    double best = 1e100;
+    for (int r = 0; r < 5; ++r) {
+        long long sum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        overflows = 0;
+        for (size_t i = 0; i < count; ++i) {
+            try {
+                F result = (a[i] + b[i]) * c[i] / d[i] - a[i];
+                sum += static_cast<long long>(result.getNumerator() % 1000) + static_cast<long long>(result.getDenominator() % 1000);
+            }
+            catch (const std::overflow_error&) {
+                ++overflows;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        best = std::min(best, elapsed.count());
+        checksum = sum;
+    }
+    return best / count * 1e9;
+}
+
+void runBenchmark(size_t count = 1 << 20) {
+    std::vector<int> values(count * 8);
+    uint64_t state = 42;
+    for (size_t k = 0; k < values.size(); ++k) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int v = static_cast<int>((state >> 33) % 99) + 1;
+        // Нечетные позиции - знаменатели, четные - числители со знаком
+        values[k] = k % 2 == 1 ? v : ((state >> 20) & 1 ? v : -v);
+    }
+
+    auto report = [](const char* title, double ns, long long checksum, size_t overflows) {
+        std::cout << std::setw(22) << title << ": " << std::setw(8) << ns << " ns, overflows "
+            << overflows << " (checksum " << checksum << ")" << std::endl;
+    };
+
+    std::cout << "(a + b) * c / d - a, " << count << " chains" << std::endl;
+    long long checksum = 0;
+    size_t overflows = 0;
+    double ns = chainBenchmark<NaiveFraction, int64_t>(values, checksum, overflows);
+    report("naive int64 + Euclid", ns, checksum, overflows);
+    ns = chainBenchmark<Fraction, int32_t>(values, checksum, overflows);
+    report("Fraction<int32_t>", ns, checksum, overflows);
+    ns = chainBenchmark<Fraction64, int64_t>(values, checksum, overflows);
+    report("Fraction<int64_t>", ns, checksum, overflows);
+#ifdef FRACTION_HAS_INT128
+    ns = chainBenchmark<Fraction128, __int128>(values, checksum, overflows);
+    report("Fraction<__int128>", ns, checksum, overflows);
+#endif
+}
+
+// Сумма count дробей со знаменателями 1..16 (их НОК равен 720720):
+// сложение Fraction с сокращением на каждом шаге, накопитель и
+// параллельная сумма FractionArray
+void runSumBenchmark(size_t count = 1 << 20) {
+    FractionArray<int64_t> values;
+    values.reserve(count);
+    uint64_t state = 7;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t num = static_cast<int64_t>((state >> 33) % 2001) - 1000;
+        int64_t denom = static_cast<int64_t>((state >> 20) % 16) + 1;
+        values.push_back(num, denom);
+    }
+
+    auto measure = [&](const char* title, auto run) {
+        double best = 1e100;
+        Fraction64 result;
+        for (int r = 0; r < 5; ++r) {
+            auto begin = std::chrono::steady_clock::now();
+            result = run();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            best = std::min(best, elapsed.count());
+        }
+        std::cout << std::setw(22) << title << ": " << std::setw(8) << best * 1e3 << " ms, "
+            << best / count * 1e9 << " ns/term (sum " << result << ")" << std::endl;
+    };
+
+    std::cout << "Sum of " << count << " fractions, " << std::thread::hardware_concurrency() << " threads" << std::endl;
+    measure("Fraction +=", [&]() {
+        Fraction64 sum;
+        for (size_t i = 0; i < count; ++i) {
+            sum = sum + Fraction64(values.getNumerators()[i], values.getDenominators()[i]);
+        }
+        return sum;
+    });
+    measure("FractionAccumulator", [&]() {
+        FractionAccumulator<int64_t> acc;
+        values.accumulate(acc, 0, count);
+        return acc.result();
+    });
+    measure("FractionArray::sum", [&]() {
+        return values.sum();
+    });
+}
+
+// Разбор count десятичных чисел вида -123.4567: прежний путь через
+// std::stod и масштабирование на 10^6, разбор в один поток и во все потоки
+void runParseBenchmark(size_t count = 1 << 22) {
+    std::string text;
+    text.reserve(count * 10);
+    uint64_t state = 11;
+    char token[32];
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int whole = static_cast<int>((state >> 33) % 2000) - 1000;
+        int fraction = static_cast<int>((state >> 17) % 10000);
+        std::snprintf(token, sizeof(token), "%s%d.%04d\n", whole < 0 ? "-" : "", std::abs(whole), fraction);
+        text += token;
+    }
+
+    auto measure = [&](const char* title, auto run) {
+        double best = 1e100;
+        long long checksum = 0;
+        for (int r = 0; r < 3; ++r) {
+            auto begin = std::chrono::steady_clock::now();
+            checksum = run();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+            best = std::min(best, elapsed.count());
+        }
+        std::cout << std::setw(22) << title << ": " << std::setw(8) << best * 1e3 << " ms, "
+            << best / count * 1e9 << " ns/value, " << text.size() / best / 1e6 << " MB/s (checksum " << checksum << ")" << std::endl;
+    };
+
+    auto checksumOf = [](const FractionArray<int32_t>& values) {
+        long long sum = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            sum += values.getNumerators()[i] % 1000 + values.getDenominators()[i] % 1000;
+        }
+        return sum;
+    };
+
+    std::cout << "Parse " << count << " decimals (" << text.size() / 1e6 << " MB)" << std::endl;
+    measure("stod + scale 10^6", [&]() {
+        FractionArray<int32_t> values;
+        values.reserve(count);
+        const char* p = text.c_str();
+        char* end;
+        for (size_t i = 0; i < count; ++i, p = end) {
+            double value = std::strtod(p, &end);
+            values.push_back(Fraction(static_cast<int32_t>(std::round(value * 1000000)), 1000000));
+        }
+        return checksumOf(values);
+    });
+    measure("parseDecimals, 1 thread", [&]() {
+        return checksumOf(parseDecimals<int32_t>(text.data(), text.size(), 1));
+    });
+    measure("parseDecimals", [&]() {
+        return checksumOf(parseDecimals<int32_t>(text.data(), text.size()));
+    });
+}
+
+// Цепочки (a + b) * c / d - a в нескольких потоках, у каждого свои данные;
+// возвращает общее число цепочек в секунду
+template <bool Counted>
+double threadedChains(unsigned threads, size_t chainsPerThread) {
+    typedef BasicFraction<int64_t, Counted> F;
+    std::atomic<long long> checksum(0);
+
+    auto work = [&](unsigned t) {
+        uint64_t state = 1000 + t;
+        auto next = [&state]() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return static_cast<int64_t>((state >> 33) % 99) + 1;
+        };
+        std::vector<F> values;
+        values.reserve(1024);
+        for (int k = 0; k < 1024; ++k) {
+            values.push_back(F(next() - 50, next()));
+        }
+        long long sum = 0;
+        for (size_t i = 0; i < chainsPerThread; ++i) {
+            const F& a = values[i % 1021];
+            const F& b = values[(i + 1) % 1021];
+            const F& c = values[(i + 2) % 1021];
+            const F& d = values[(i + 3) % 1021 + 1];
+            if (d.getNumerator() == 0) {
+                continue;
+            }
+            F result = (a + b) * c / d - a;
+            sum += result.getNumerator() % 1000;
+        }
+        checksum += sum;
+    };
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return threads * chainsPerThread / elapsed.count();
+}
+
+// Масштабирование арифметики по потокам с подсчетом экземпляров и без него
+void runThreadBenchmark(size_t chainsPerThread = 1 << 20) {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::setw(8) << "threads" << std::setw(16) << "counted" << std::setw(16) << "not counted"
+        << std::setw(10) << "speedup" << "  (million chains/s)" << std::endl;
+
+    double base = 0;
+    for (unsigned threads = 1;; threads = std::min(maxThreads, threads * 2)) {
+        double counted = threadedChains<true>(threads, chainsPerThread) / 1e6;
+        double plain = threadedChains<false>(threads, chainsPerThread) / 1e6;
+        if (threads == 1) {
+            base = counted;
+        }
+        std::cout << std::setw(8) << threads << std::setw(16) << counted << std::setw(16) << plain
+            << std::setw(10) << counted / base << std::endl;
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+    std::cout << "Live Fraction64 instances: " << Fraction64::getInstanceCount() << std::endl;
+}
+
+// Прежний способ: метод Гаусса над дробями, НОД на каждой операции
+template <typename Int>
+std::vector<BasicFraction<Int>> gaussSolve(const RationalMatrix<Int>& matrix, std::vector<BasicFraction<Int>> b) {
+    typedef BasicFraction<Int> F;
+    const size_t n = matrix.getRows();
+    std::vector<F> a;
+    a.reserve(n * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            a.push_back(matrix.at(i, j));
+        }
+    }
+    for (size_t k = 0; k < n; ++k) {
+        size_t pivot = k;
+        while (pivot < n && a[pivot * n + k].getNumerator() == 0) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            throw std::invalid_argument("Matrix is singular");
+        }
+        std::swap_ranges(a.begin() + pivot * n, a.begin() + (pivot + 1) * n, a.begin() + k * n);
+        std::swap(b[pivot], b[k]);
+        for (size_t i = k + 1; i < n; ++i) {
+            F factor = a[i * n + k] / a[k * n + k];
+            for (size_t j = k; j < n; ++j) {
+                a[i * n + j] = a[i * n + j] - factor * a[k * n + j];
+            }
+            b[i] = b[i] - factor * b[k];
+        }
+    }
+    std::vector<F> x(n);
+    for (size_t i = n; i-- > 0;) {
+        F value = b[i];
+        for (size_t j = i + 1; j < n; ++j) {
+            value = value - a[i * n + j] * x[j];
+        }
+        x[i] = value / a[i * n + i];
+    }
+    return x;
+}
+
+// Матрица n x n вида L * U: L и U - треугольные с единицами на диагонали
+// и редкими элементами от -2 до 2. Определитель равен 1, а миноры остаются
+// небольшими, поэтому точное решение помещается в 64 бита. Дробные
+// элементы здесь не годятся: множители строк входят в определитель
+// целой матрицы и при n = 200 переполняют любой встроенный тип.
+RationalMatrix<int64_t> makeTestMatrix(size_t n, uint64_t seed) {
+    auto next = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>(seed >> 33);
+    };
+    std::vector<long long> lower(n * n, 0), upper(n * n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        lower[i * n + i] = upper[i * n + i] = 1;
+        for (size_t j = 0; j < i; ++j) {
+            if (next() % static_cast<int>(n) < 3) {
+                lower[i * n + j] = next() % 5 - 2;
+            }
+            if (next() % static_cast<int>(n) < 3) {
+                upper[j * n + i] = next() % 5 - 2;
+            }
+        }
+    }
+    RationalMatrix<int64_t> matrix(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            long long sum = 0;
+            for (size_t k = 0; k <= std::min(i, j); ++k) {
+                sum += lower[i * n + k] * upper[k * n + j];
+            }
+            matrix.setAt(i, j, sum);
+        }
+    }
+    return matrix;
+}
+
+// Решение систем до 200 x 200: метод Гаусса над Fraction64, исключение
+// Барейса в один поток и во все потоки; определитель и обратная матрица
+void runSolveBenchmark() {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    auto seconds = [](std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+    std::cout << std::setw(6) << "n" << std::setw(14) << "Gauss" << std::setw(14) << "Bareiss x1"
+        << std::setw(14) << "Bareiss x" << std::left << std::setw(4) << threads << std::right
+        << std::setw(14) << "det" << std::setw(14) << "inverse" << "  (ms)" << std::endl;
+
+    const size_t sizes[] = { 25, 50, 100, 200 };
+    for (size_t n : sizes) {
+        RationalMatrix<int64_t> matrix = makeTestMatrix(n, n);
+        std::vector<Fraction64> b;
+        for (size_t i = 0; i < n; ++i) {
+            b.push_back(Fraction64(static_cast<int64_t>(i % 7) - 3, static_cast<int64_t>(i % 5) + 1));
+        }
+        std::cout << std::setw(6) << n << std::fixed << std::setprecision(2);
+
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<Fraction64> expected;
+        try {
+            expected = gaussSolve(matrix, b);
+            std::cout << std::setw(14) << seconds(begin) * 1e3;
+        }
+        catch (const std::overflow_error&) {
+            std::cout << std::setw(14) << "overflow";
+        }
+
+        begin = std::chrono::steady_clock::now();
+        std::vector<Fraction64> x = matrix.solve(b, 1);
+        std::cout << std::setw(14) << seconds(begin) * 1e3;
+
+        begin = std::chrono::steady_clock::now();
+        std::vector<Fraction64> parallel = matrix.solve(b, threads);
+        std::cout << std::setw(18) << seconds(begin) * 1e3;
+
+        begin = std::chrono::steady_clock::now();
+        Fraction64 det = matrix.determinant(threads);
+        std::cout << std::setw(14) << seconds(begin) * 1e3;
+
+        try {
+            begin = std::chrono::steady_clock::now();
+            RationalMatrix<int64_t> inverse = matrix.inverse(threads);
+            std::cout << std::setw(14) << seconds(begin) * 1e3;
+        }
+        catch (const std::overflow_error&) {
+            std::cout << std::setw(14) << "overflow";
+        }
+
+        bool same = !expected.empty() || n == 0;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            same = same && expected[i].getNumerator() == x[i].getNumerator()
+                && expected[i].getDenominator() == x[i].getDenominator();
+        }
+        for (size_t i = 0; i < n; ++i) {
+            same = same && parallel[i].getNumerator() == x[i].getNumerator()
+                && parallel[i].getDenominator() == x[i].getDenominator();
+        }
+        std::cout << "  det " << det << (same ? "" : "  MISMATCH") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        runBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-sum") == 0) {
+        runSumBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-parse") == 0) {
+        runParseBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-threads") == 0) {
+        runThreadBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-solve") == 0) {
+        runSolveBenchmark();
+        return 0;
+    }
 
-int main() {
     try {
         Fraction a(1, 2);
         Fraction b(3, 4);
@@ -119,7 +1942,47 @@ int main() {
         std::cout << "String \"0.43\" as fraction: ";
         Fraction::printAsFraction("0.43");
 
+        // Точный разбор и наилучшее приближение
+        std::cout << "\"-12.375\" exactly: " << Fraction::fromDecimal("-12.375") << std::endl;
+        std::cout << "\"3.14159265358979\" with denominator <= 1000: "
+            << Fraction::fromDecimal("3.14159265358979", 1000) << std::endl;
+
         std::cout << "Current number of Fraction instances: " << Fraction::getInstanceCount() << std::endl;
+
+        // Переполнение обнаруживается, а не дает неверный результат
+        Fraction big(2000000000, 3);
+        try {
+            Fraction doubled = big * Fraction(2);
+            std::cout << "big * 2 = " << doubled << std::endl;
+        }
+        catch (const std::overflow_error& e) {
+            std::cout << "big * 2: " << e.what() << std::endl;
+        }
+        // Частичная сумма гармонического ряда без сокращения на каждом шаге
+        FractionAccumulator<int32_t> harmonic;
+        for (int k = 1; k <= 20; ++k) {
+            harmonic.add(1, k);
+        }
+        std::cout << "1 + 1/2 + ... + 1/20 = " << harmonic.result() << std::endl;
+
+        // Точное решение системы x + y / 2 = 1, x / 3 - y = 1 / 4
+        RationalMatrix<int64_t> system(2, 2);
+        system.setAt(0, 0, 1);
+        system.setAt(0, 1, 1, 2);
+        system.setAt(1, 0, 1, 3);
+        system.setAt(1, 1, -1);
+        std::vector<Fraction64> solution = system.solve({ Fraction64(1), Fraction64(1, 4) });
+        std::cout << "det = " << system.determinant() << ", x = " << solution[0] << ", y = " << solution[1] << std::endl;
+        std::cout << "Inverse:" << std::endl;
+        system.inverse().print();
+
+        // Коэффициенты сворачиваются при компиляции в одну дробь
+        constexpr ConstFraction64 rate = (ConstFraction64(3, 8) + ConstFraction64(1, 12)) * ConstFraction64(6, 11) / ConstFraction64(5, 4);
+        static_assert(rate.getNumerator() == 1 && rate.getDenominator() == 5, "constant folding");
+        std::cout << "(3/8 + 1/12) * 6/11 / (5/4) = " << rate << std::endl;
+        std::cout << "rate * (x = 27/28) = " << rate * solution[0] << std::endl;
+
+        std::cout << "big * 2 in 64 bits = " << (Fraction64(2000000000, 3) * Fraction64(2)) << std::endl;
     }
     catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
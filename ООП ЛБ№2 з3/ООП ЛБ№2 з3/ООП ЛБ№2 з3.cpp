@@ -5,6 +5,182 @@
 #include <algorithm>
 #include <ctime>
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <iterator>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+// Двоичный столбцовый формат списка студентов (порядок байтов машины):
+//   StudentFileHeader (64 байта)
+//   int32_t  birthYear[count]
+//   int32_t  enrollmentYear[count]
+//   double   averageGrade[count]
+//   uint64_t nameOffset[count + 1], genderOffset[count + 1], recordBookOffset[count + 1]
+//   char     heap[heapSize]
+// Строка i поля f занимает heap[offset[i], offset[i + 1]); строки каждого
+// поля лежат в куче подряд. Все столбцы выровнены по своему размеру.
+const uint32_t STUDENT_FILE_VERSION = 1;
+const char STUDENT_FILE_MAGIC[4] = { 'S', 'T', 'U', 'D' };
+
+struct StudentFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    uint64_t heapSize;
+    uint64_t checksum; // Контрольная сумма полей count и heapSize и всего, что идет после заголовка
+    char reserved[32];
+};
+
+static_assert(sizeof(StudentFileHeader) == 64, "Student file header must take 64 bytes");
+
+// Контрольная сумма по 8 байт за шаг. Данные можно подавать участками
+// любой длины: результат тот же, что для одного непрерывного блока.
+class Checksum64 {
+private:
+    uint64_t hash;
+    unsigned char tail[8];
+    size_t tailSize;
+
+    void mix(uint64_t word) {
+        hash = (hash ^ word) * 0x100000001B3ULL;
+        hash ^= hash >> 29;
+    }
+
+public:
+    Checksum64() : hash(0xCBF29CE484222325ULL), tailSize(0) {}
+
+    void update(const void* data, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        while (tailSize > 0 && tailSize < 8 && size > 0) {
+            tail[tailSize++] = *p++;
+            --size;
+        }
+        uint64_t word;
+        if (tailSize == 8) {
+            std::memcpy(&word, tail, 8);
+            mix(word);
+            tailSize = 0;
+        }
+        for (; size >= 8; p += 8, size -= 8) {
+            std::memcpy(&word, p, 8);
+            mix(word);
+        }
+        for (; size > 0; ++p, --size) {
+            tail[tailSize++] = *p;
+        }
+    }
+
+    uint64_t value() const {
+        uint64_t result = hash;
+        for (size_t k = 0; k < tailSize; ++k) {
+            result = (result ^ tail[k]) * 0x100000001B3ULL;
+        }
+        return result;
+    }
+
+    // Состояние в двух словах: хэш и недописанный хвост (байты в младших
+    // разрядах, их число - в старшем байте). По сохраненному состоянию
+    // подсчет продолжается, например после дописывания файла.
+    void save(uint64_t& savedHash, uint64_t& savedTail) const {
+        savedHash = hash;
+        savedTail = static_cast<uint64_t>(tailSize) << 56;
+        for (size_t k = 0; k < tailSize; ++k) {
+            savedTail |= static_cast<uint64_t>(tail[k]) << (8 * k);
+        }
+    }
+
+    void restore(uint64_t savedHash, uint64_t savedTail) {
+        hash = savedHash;
+        tailSize = static_cast<size_t>(savedTail >> 56) % 8;
+        for (size_t k = 0; k < tailSize; ++k) {
+            tail[k] = static_cast<unsigned char>(savedTail >> (8 * k));
+        }
+    }
+};
+
+// Участок памяти для записи в файл
+struct FileSegment {
+    const void* data;
+    size_t size;
+};
+
+// Запись участков в новый файл: одним writev там, где он есть, иначе
+// одним потоком с большими блоками
+inline void writeSegments(const std::string& filename, const std::vector<FileSegment>& segments) {
+#if defined(_WIN32)
+    std::ofstream outFile(filename, std::ios::binary | std::ios::trunc);
+    for (const FileSegment& segment : segments) {
+        outFile.write(static_cast<const char*>(segment.data), static_cast<std::streamsize>(segment.size));
+    }
+    if (!outFile) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+#else
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    std::vector<iovec> pending;
+    for (const FileSegment& segment : segments) {
+        if (segment.size != 0) {
+            pending.push_back(iovec{ const_cast<void*>(segment.data), segment.size });
+        }
+    }
+    // writev может записать меньше запрошенного: пропускаем записанное
+    size_t first = 0;
+    while (first < pending.size()) {
+        int chunk = static_cast<int>(std::min<size_t>(pending.size() - first, IOV_MAX));
+        ssize_t written = writev(fd, &pending[first], chunk);
+        if (written < 0) {
+            close(fd);
+            throw std::runtime_error("Cannot write file: " + filename);
+        }
+        size_t rest = static_cast<size_t>(written);
+        while (first < pending.size() && rest >= pending[first].iov_len) {
+            rest -= pending[first].iov_len;
+            ++first;
+        }
+        if (rest > 0) {
+            pending[first].iov_base = static_cast<char*>(pending[first].iov_base) + rest;
+            pending[first].iov_len -= rest;
+        }
+    }
+    if (close(fd) != 0) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+#endif
+}
+
+// Итоги одной сессии
+struct SessionResult {
+    int sum;
+    int count;
+
+    double average() const {
+        return count > 0 ? static_cast<double>(sum) / count : 0.0;
+    }
+};
 
 class Student {
 private:
@@ -14,16 +190,22 @@ private:
     int enrollmentYear;
     std::string recordBookNumber;
     double averageGrade;
+    // Сумма и число оценок за все сессии и итоги каждой сессии
+    long long gradeSum;
+    long long gradeCount;
+    std::vector<SessionResult> sessions;
 
 public:
     // Конструктор по умолчанию
     Student()
-        : fullName(""), gender(""), birthYear(0), enrollmentYear(0), recordBookNumber(""), averageGrade(0.0) {
+        : fullName(""), gender(""), birthYear(0), enrollmentYear(0), recordBookNumber(""), averageGrade(0.0),
+        gradeSum(0), gradeCount(0) {
     }
 
     // Конструктор с параметрами
     Student(const std::string& name, const std::string& gen, int birth, int enrollment, const std::string& recordBook, double grade)
-        : fullName(name), gender(gen), birthYear(birth), enrollmentYear(enrollment), recordBookNumber(recordBook), averageGrade(grade) {
+        : fullName(name), gender(gen), birthYear(birth), enrollmentYear(enrollment), recordBookNumber(recordBook), averageGrade(grade),
+        gradeSum(0), gradeCount(0) {
     }
 
     // Сеттеры
@@ -35,20 +217,44 @@ public:
     void setAverageGrade(double grade) { averageGrade = grade; }
 
     // Геттеры
-    std::string getFullName() const { return fullName; }
-    std::string getGender() const { return gender; }
+    const std::string& getFullName() const { return fullName; }
+    const std::string& getGender() const { return gender; }
     int getBirthYear() const { return birthYear; }
     int getEnrollmentYear() const { return enrollmentYear; }
-    std::string getRecordBookNumber() const { return recordBookNumber; }
+    const std::string& getRecordBookNumber() const { return recordBookNumber; }
     double getAverageGrade() const { return averageGrade; }
+    long long getGradeSum() const { return gradeSum; }
+    long long getGradeCount() const { return gradeCount; }
+    const std::vector<SessionResult>& getSessions() const { return sessions; }
 
-    // Метод для пересчета среднего балла
+    // Метод для пересчета среднего балла: grades - все оценки студента,
+    // поэтому накопленные итоги сессий сбрасываются и заменяются одной
+    // сессией с этими оценками
     void recalculateAverageGrade(const std::vector<int>& grades) {
+        gradeSum = 0;
+        gradeCount = 0;
+        sessions.clear();
+        addSession(grades);
+    }
+
+    // Итоги очередной сессии: средний балл считается по всем оценкам всех
+    // сессий из накопленных суммы и числа оценок, без пересчета истории.
+    // Балл, заданный вручную до первой сессии, в среднем не учитывается.
+    void addSession(int sum, int count) {
+        sessions.push_back(SessionResult{ sum, count });
+        gradeSum += sum;
+        gradeCount += count;
+        if (gradeCount > 0) {
+            averageGrade = static_cast<double>(gradeSum) / gradeCount;
+        }
+    }
+
+    void addSession(const std::vector<int>& grades) {
         int sum = 0;
         for (int grade : grades) {
             sum += grade;
         }
-        averageGrade = static_cast<double>(sum) / grades.size();
+        addSession(sum, static_cast<int>(grades.size()));
     }
 
     // Методы сериализации
@@ -69,6 +275,62 @@ public:
         }
     }
 
+    // Запись всего списка в двоичный столбцовый файл (см. StudentFileHeader).
+    // Столбцы собираются в памяти и записываются за один проход вместо
+    // открытия файла и форматирования текста для каждого студента.
+    static void serializeAll(const std::vector<Student>& students, const std::string& filename) {
+        const size_t count = students.size();
+        std::vector<int32_t> birthYears(count), enrollmentYears(count);
+        std::vector<double> grades(count);
+        for (size_t i = 0; i < count; ++i) {
+            birthYears[i] = students[i].birthYear;
+            enrollmentYears[i] = students[i].enrollmentYear;
+            grades[i] = students[i].averageGrade;
+        }
+
+        std::string Student::* const fields[3] = { &Student::fullName, &Student::gender, &Student::recordBookNumber };
+        size_t heapSize = 0;
+        for (const Student& student : students) {
+            heapSize += student.fullName.size() + student.gender.size() + student.recordBookNumber.size();
+        }
+        std::string heap;
+        heap.reserve(heapSize);
+        std::vector<uint64_t> offsets(3 * (count + 1));
+        for (size_t f = 0; f < 3; ++f) {
+            uint64_t* column = &offsets[f * (count + 1)];
+            for (size_t i = 0; i < count; ++i) {
+                column[i] = heap.size();
+                heap += students[i].*fields[f];
+            }
+            column[count] = heap.size();
+        }
+
+        std::vector<FileSegment> segments = {
+            { nullptr, sizeof(StudentFileHeader) },
+            { birthYears.data(), count * sizeof(int32_t) },
+            { enrollmentYears.data(), count * sizeof(int32_t) },
+            { grades.data(), count * sizeof(double) },
+            { offsets.data(), offsets.size() * sizeof(uint64_t) },
+            { heap.data(), heap.size() },
+        };
+
+        StudentFileHeader header = {};
+        std::memcpy(header.magic, STUDENT_FILE_MAGIC, sizeof(header.magic));
+        header.version = STUDENT_FILE_VERSION;
+        header.count = count;
+        header.heapSize = heap.size();
+        Checksum64 checksum;
+        checksum.update(&header.count, sizeof(header.count));
+        checksum.update(&header.heapSize, sizeof(header.heapSize));
+        for (size_t k = 1; k < segments.size(); ++k) {
+            checksum.update(segments[k].data, segments[k].size);
+        }
+        header.checksum = checksum.value();
+        segments[0].data = &header;
+
+        writeSegments(filename, segments);
+    }
+
     // Методы десериализации
     void deserialize() {
         deserialize("student_data.txt");
@@ -99,47 +361,1985 @@ public:
     }
 };
 
-int main() {
-    // Массив из трех студентов
-    std::vector<Student> students(3);
+// Строка внутри отображенного файла без копирования
+struct StringRef {
+    const char* data;
+    size_t size;
 
-    // Установка данных через сеттеры
-    students[0].setFullName("Alice Smith");
-    students[0].setGender("Female");
-    students[0].setBirthYear(2002);
-    students[0].setEnrollmentYear(2020);
-    students[0].setRecordBookNumber("AB123");
-    students[0].setAverageGrade(4.5);
+    std::string str() const { return std::string(data, size); }
 
-    students[1].setFullName("Bob Johnson");
-    students[1].setGender("Male");
-    students[1].setBirthYear(2001);
-    students[1].setEnrollmentYear(2019);
-    students[1].setRecordBookNumber("BC234");
-    students[1].setAverageGrade(3.8);
+    bool operator==(const std::string& other) const {
+        return size == other.size() && std::memcmp(data, other.data(), size) == 0;
+    }
+};
 
-    students[2].setFullName("Carol White");
-    students[2].setGender("Female");
-    students[2].setBirthYear(2000);
-    students[2].setEnrollmentYear(2018);
-    students[2].setRecordBookNumber("CD345");
-    students[2].setAverageGrade(4.2);
+inline std::ostream& operator<<(std::ostream& os, const StringRef& text) {
+    return os.write(text.data, static_cast<std::streamsize>(text.size));
+}
 
-    // Студент в куче
-    Student* dynamicStudent = new Student("David Brown", "Male", 2003, 2021, "DE456", 4.7);
+// Запись о студенте, строки которой указывают в отображенный файл.
+// Действительна, пока жив StudentReader; Student создается только по запросу.
+struct StudentView {
+    StringRef fullName;
+    StringRef gender;
+    int birthYear;
+    int enrollmentYear;
+    StringRef recordBookNumber;
+    double averageGrade;
+    // Положение записи для StudentReader::at(): номер в двоичном файле,
+    // смещение первой строки в текстовом
+    uint64_t position;
+
+    Student toStudent() const {
+        return Student(fullName.str(), gender.str(), birthYear, enrollmentYear, recordBookNumber.str(), averageGrade);
+    }
+};
+
+// Способ открытия отображаемого файла
+enum class MapMode {
+    Read,   // Существующий файл только для чтения
+    Write,  // Существующий файл для чтения и записи
+    Create  // Новый файл заданного размера, заполненный нулями
+};
+
+// Файл, целиком отображенный в память
+class MappedFile {
+private:
+    char* base;
+    size_t fileSize;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path, MapMode mode = MapMode::Read, size_t size = 0)
+        : base(nullptr), fileSize(0) {
+        const bool writable = mode != MapMode::Read;
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+            nullptr, mode == MapMode::Create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        LARGE_INTEGER length;
+        if (mode == MapMode::Create) {
+            length.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFilePointerEx(file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+                CloseHandle(file);
+                throw std::runtime_error("Cannot resize file: " + path);
+            }
+        }
+        if (!GetFileSizeEx(file, &length)) {
+            CloseHandle(file);
+            throw std::runtime_error("Cannot read file size: " + path);
+        }
+        fileSize = static_cast<size_t>(length.QuadPart);
+        mapping = nullptr;
+        if (fileSize > 0) {
+            mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+            base = mapping != nullptr
+                ? static_cast<char*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0))
+                : nullptr;
+            if (base == nullptr) {
+                if (mapping != nullptr) {
+                    CloseHandle(mapping);
+                }
+                CloseHandle(file);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+        }
+#else
+        int flags = mode == MapMode::Create ? O_RDWR | O_CREAT | O_TRUNC : (writable ? O_RDWR : O_RDONLY);
+        fd = open(path.c_str(), flags, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        if (mode == MapMode::Create && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot resize file: " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot read file size: " + path);
+        }
+        fileSize = static_cast<size_t>(info.st_size);
+        if (fileSize > 0) {
+            void* address = mmap(nullptr, fileSize, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+            base = static_cast<char*>(address);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (base != nullptr) {
+            UnmapViewOfFile(base);
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+#else
+        if (base != nullptr) {
+            munmap(base, fileSize);
+        }
+        close(fd);
+#endif
+    }
+
+    // Файл будет читаться от начала до конца: чтение вперед крупными блоками
+    void adviseSequential() const {
+#if !defined(_WIN32)
+        if (base != nullptr) {
+            madvise(base, fileSize, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    const char* data() const { return base; }
+    char* writableData() { return base; }
+    size_t size() const { return fileSize; }
+};
+
+// Потоковое чтение всех студентов из файла в текстовом формате serialize()
+// (по шесть строк на запись) или в двоичном формате serializeAll().
+// Формат определяется по сигнатуре. Записи выдаются как StudentView без
+// копирования строк; fn(view, index) получает также номер записи.
+// При параллельном чтении файл делится на участки по границам записей:
+// для двоичного формата - по номерам, для текстового - по строкам, номер
+// первой строки каждого участка дает предварительный подсчет строк.
+class StudentReader {
+private:
+    static const size_t LINES_PER_RECORD = 6;
+
+    MappedFile file;
+    bool binary;
+    size_t binaryCount;
+    const int32_t* birthYears;
+    const int32_t* enrollmentYears;
+    const double* grades;
+    const uint64_t* offsets;
+    const char* heap;
+
+    [[noreturn]] void fail(const char* problem, const char* at) const {
+        throw std::runtime_error(std::string(problem) + " at offset " + std::to_string(at - file.data()));
+    }
+
+    // Проверка заголовка и смещений строк двоичного файла
+    void openBinary() {
+        StudentFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.version != STUDENT_FILE_VERSION) {
+            throw std::runtime_error("Unsupported student file version");
+        }
+        uint64_t count = header.count;
+        uint64_t body = file.size() - sizeof(StudentFileHeader);
+        // 40 байт на запись: два int32, double и три смещения, плюс три
+        // завершающих смещения. Сравнения построены так, чтобы не переполняться.
+        if (header.heapSize > body || count > (body - header.heapSize) / 40
+            || 40 * count + 24 + header.heapSize != body) {
+            throw std::runtime_error("Student file size does not match its header");
+        }
+        binaryCount = static_cast<size_t>(count);
+        const char* p = file.data() + sizeof(StudentFileHeader);
+        birthYears = reinterpret_cast<const int32_t*>(p);
+        enrollmentYears = birthYears + count;
+        grades = reinterpret_cast<const double*>(enrollmentYears + count);
+        offsets = reinterpret_cast<const uint64_t*>(grades + count);
+        heap = reinterpret_cast<const char*>(offsets + 3 * (count + 1));
+        uint64_t previous = 0;
+        for (size_t k = 0; k < 3 * (count + 1); ++k) {
+            if (offsets[k] < previous && k % (count + 1) != 0) {
+                throw std::runtime_error("Invalid string offsets in student file");
+            }
+            if (offsets[k] > header.heapSize) {
+                throw std::runtime_error("Invalid string offsets in student file");
+            }
+            previous = offsets[k];
+        }
+    }
+
+    StudentView binaryRecord(size_t i) const {
+        const uint64_t* names = offsets;
+        const uint64_t* genders = names + binaryCount + 1;
+        const uint64_t* books = genders + binaryCount + 1;
+        StudentView view;
+        view.fullName = StringRef{ heap + names[i], static_cast<size_t>(names[i + 1] - names[i]) };
+        view.gender = StringRef{ heap + genders[i], static_cast<size_t>(genders[i + 1] - genders[i]) };
+        view.birthYear = birthYears[i];
+        view.enrollmentYear = enrollmentYears[i];
+        view.recordBookNumber = StringRef{ heap + books[i], static_cast<size_t>(books[i + 1] - books[i]) };
+        view.averageGrade = grades[i];
+        view.position = i;
+        return view;
+    }
+
+    // Очередная строка, начиная с p; p сдвигается за перевод строки.
+    // Завершающий '\r' (файлы, записанные в текстовом режиме Windows) отбрасывается.
+    StringRef nextLine(const char*& p) const {
+        const char* end = file.data() + file.size();
+        if (p == end) {
+            fail("Truncated record", p);
+        }
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        StringRef line{ p, static_cast<size_t>(lineEnd - p) };
+        if (line.size > 0 && line.data[line.size - 1] == '\r') {
+            --line.size;
+        }
+        p = newline != nullptr ? newline + 1 : end;
+        return line;
+    }
+
+    int parseInt(StringRef line) const {
+        const char* p = line.data;
+        const char* end = line.data + line.size;
+        bool negative = p != end && *p == '-';
+        if (negative) {
+            ++p;
+        }
+        if (p == end) {
+            fail("Invalid number", line.data);
+        }
+        // По модулю отрицательное число может быть на единицу больше INT32_MAX
+        const long long limit = negative ? -static_cast<long long>(INT32_MIN) : INT32_MAX;
+        long long value = 0;
+        for (; p != end; ++p) {
+            if (*p < '0' || *p > '9') {
+                fail("Invalid number", line.data);
+            }
+            value = value * 10 + (*p - '0');
+            if (value > limit) {
+                fail("Invalid number", line.data);
+            }
+        }
+        return static_cast<int>(negative ? -value : value);
+    }
+
+    double parseDouble(StringRef line) const {
+        // strtod требует завершающий ноль, а строки файла его не имеют
+        char buffer[64];
+        if (line.size == 0 || line.size >= sizeof(buffer)) {
+            fail("Invalid number", line.data);
+        }
+        std::memcpy(buffer, line.data, line.size);
+        buffer[line.size] = '\0';
+        char* end;
+        double value = std::strtod(buffer, &end);
+        if (end != buffer + line.size) {
+            fail("Invalid number", line.data);
+        }
+        return value;
+    }
+
+    // Текстовая запись, начинающаяся с p; p сдвигается на следующую
+    StudentView textRecord(const char*& p) const {
+        StudentView view;
+        view.position = static_cast<uint64_t>(p - file.data());
+        view.fullName = nextLine(p);
+        view.gender = nextLine(p);
+        view.birthYear = parseInt(nextLine(p));
+        view.enrollmentYear = parseInt(nextLine(p));
+        view.recordBookNumber = nextLine(p);
+        view.averageGrade = parseDouble(nextLine(p));
+        return view;
+    }
+
+    // Число строк в [first, last); first - начало строки
+    size_t countLines(const char* first, const char* last) const {
+        size_t lines = static_cast<size_t>(std::count(first, last, '\n'));
+        const char* end = file.data() + file.size();
+        if (last == end && first != last && last[-1] != '\n') {
+            ++lines; // Последняя строка без перевода строки
+        }
+        return lines;
+    }
+
+public:
+    explicit StudentReader(const std::string& path)
+        : file(path), binary(false), binaryCount(0), birthYears(nullptr), enrollmentYears(nullptr),
+        grades(nullptr), offsets(nullptr), heap(nullptr) {
+        if (file.size() >= sizeof(StudentFileHeader) &&
+            std::memcmp(file.data(), STUDENT_FILE_MAGIC, sizeof(STUDENT_FILE_MAGIC)) == 0) {
+            binary = true;
+            openBinary();
+        }
+    }
+
+    bool isBinary() const {
+        return binary;
+    }
+
+    // Размер файла данных в байтах
+    size_t fileSize() const {
+        return file.size();
+    }
+
+    // Запись по положению из StudentView::position
+    StudentView at(uint64_t position) const {
+        if (binary) {
+            if (position >= binaryCount) {
+                throw std::out_of_range("Record position out of range");
+            }
+            return binaryRecord(static_cast<size_t>(position));
+        }
+        if (position >= file.size()) {
+            throw std::out_of_range("Record position out of range");
+        }
+        const char* p = file.data() + position;
+        return textRecord(p);
+    }
+
+    // Число записей; для текстового файла требует прохода по файлу
+    size_t count() const {
+        if (binary) {
+            return binaryCount;
+        }
+        size_t lines = countLines(file.data(), file.data() + file.size());
+        if (lines % LINES_PER_RECORD != 0) {
+            fail("Truncated record", file.data() + file.size());
+        }
+        return lines / LINES_PER_RECORD;
+    }
+
+    // Байты файла данных
+    const char* rawData() const {
+        return file.data();
+    }
+
+    // Контрольная сумма из заголовка двоичного файла (без проверки)
+    uint64_t headerChecksum() const {
+        if (!binary) {
+            throw std::logic_error("Text student files have no checksum");
+        }
+        StudentFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        return header.checksum;
+    }
+
+    // Проверка контрольной суммы двоичного файла (текстовый ее не имеет)
+    bool verifyChecksum() const {
+        if (!binary) {
+            return true;
+        }
+        StudentFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        Checksum64 checksum;
+        checksum.update(&header.count, sizeof(header.count));
+        checksum.update(&header.heapSize, sizeof(header.heapSize));
+        checksum.update(file.data() + sizeof(header), file.size() - sizeof(header));
+        return checksum.value() == header.checksum;
+    }
+
+    // Последовательный обход всех записей
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        file.adviseSequential();
+        if (binary) {
+            for (size_t i = 0; i < binaryCount; ++i) {
+                fn(binaryRecord(i), i);
+            }
+            return;
+        }
+        const char* p = file.data();
+        const char* end = p + file.size();
+        for (size_t i = 0; p != end; ++i) {
+            fn(textRecord(p), i);
+        }
+    }
+
+    // Параллельный обход: fn вызывается из нескольких потоков одновременно,
+    // записи одного потока идут по порядку
+    template <typename Fn>
+    void forEachParallel(Fn fn, unsigned threads = 0) const {
+        file.adviseSequential();
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        const size_t minChunk = 1 << 20;
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, file.size() / minChunk)));
+        if (threads == 1) {
+            forEach(fn);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(threads);
+        auto run = [&](std::function<void(unsigned)> work) {
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; ++t) {
+                pool.emplace_back([&, t]() {
+                    try {
+                        work(t);
+                    }
+                    catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+            try {
+                work(0);
+            }
+            catch (...) {
+                errors[0] = std::current_exception();
+            }
+            for (std::thread& th : pool) {
+                th.join();
+            }
+            for (std::exception_ptr& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+        if (binary) {
+            size_t step = (binaryCount + threads - 1) / threads;
+            run([&](unsigned t) {
+                size_t last = std::min(binaryCount, (t + 1) * step);
+                for (size_t i = std::min(binaryCount, t * step); i < last; ++i) {
+                    fn(binaryRecord(i), i);
+                }
+            });
+            return;
+        }
+
+        // Участки начинаются с начала строки
+        const char* data = file.data();
+        const char* end = data + file.size();
+        std::vector<const char*> bounds(threads + 1, end);
+        bounds[0] = data;
+        for (unsigned t = 1; t < threads; ++t) {
+            const char* p = std::max(bounds[t - 1], data + file.size() / threads * t);
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            bounds[t] = newline != nullptr ? newline + 1 : end;
+        }
+        std::vector<size_t> firstLine(threads + 1, 0);
+        run([&](unsigned t) {
+            firstLine[t + 1] = countLines(bounds[t], bounds[t + 1]);
+        });
+        for (unsigned t = 0; t < threads; ++t) {
+            firstLine[t + 1] += firstLine[t];
+        }
+        if (firstLine[threads] % LINES_PER_RECORD != 0) {
+            fail("Truncated record", end);
+        }
+
+        // Поток пропускает строки до первой записи, начинающейся в его
+        // участке, и читает записи, пока их начало внутри участка
+        run([&](unsigned t) {
+            const char* p = bounds[t];
+            size_t line = firstLine[t];
+            for (; line % LINES_PER_RECORD != 0 && p < bounds[t + 1]; ++line) {
+                nextLine(p);
+            }
+            for (size_t i = line / LINES_PER_RECORD; p < bounds[t + 1]; ++i) {
+                fn(textRecord(p), i);
+            }
+        });
+    }
+
+    // Все записи в виде Student
+    std::vector<Student> readAll(unsigned threads = 1) const {
+        std::vector<Student> students(count());
+        auto store = [&students](const StudentView& view, size_t index) {
+            students[index] = view.toStudent();
+        };
+        if (threads == 1) {
+            forEach(store);
+        }
+        else {
+            forEachParallel(store, threads);
+        }
+        return students;
+    }
+};
+
+// Хэш номера зачетки: FNV-1a и перемешивание битов, чтобы младшие биты,
+// по которым выбирается ячейка, зависели от всех символов
+inline uint64_t hashKey(const char* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t k = 0; k < size; ++k) {
+        hash = (hash ^ static_cast<unsigned char>(data[k])) * 0x100000001B3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Файл индекса <данные>.idx:
+//   StudentIndexHeader (80 байт)
+//   IndexSlot   slots[slotCapacity]       - открытая адресация, линейное пробирование
+//   IndexRecord records[recordCapacity]   - положение и годы записей в порядке добавления
+//   uint32_t    byBirthYear[recordCapacity], byEnrollmentYear[recordCapacity]
+// Списки по годам - номера записей, упорядоченные по году; упорядочен
+// только префикс [0, sortedCount), новые записи в конце сливаются с ним
+// пачками. Индекс отображается в память при открытии и не перестраивается,
+// если размер и отпечаток содержимого файла данных совпадают с записанными
+// в заголовке. Отпечаток двоичного файла - контрольная сумма из его
+// заголовка, текстового - состояние Checksum64 всех его байтов: при
+// дописывании студента подсчет продолжается с сохраненного состояния.
+const uint32_t STUDENT_INDEX_VERSION = 2;
+const char STUDENT_INDEX_MAGIC[4] = { 'S', 'I', 'D', 'X' };
+
+struct StudentIndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t slotCapacity; // Степень двойки
+    uint64_t recordCapacity;
+    uint64_t count;
+    uint64_t sortedCount;
+    uint64_t dataSize;     // Размер файла данных, которому соответствует индекс
+    uint64_t dataChecksum; // Отпечаток содержимого файла данных
+    uint64_t dataChecksumTail;
+    uint32_t dataBinary;
+    char reserved[12];
+};
+
+static_assert(sizeof(StudentIndexHeader) == 80, "Student index header must take 80 bytes");
+
+struct IndexSlot {
+    uint64_t hash;
+    uint64_t record; // Номер записи + 1; 0 - пустая ячейка
+};
+
+struct IndexRecord {
+    uint64_t position; // StudentView::position
+    int32_t birthYear;
+    int32_t enrollmentYear;
+};
+
+// Индекс файла студентов: поиск по номеру зачетки за O(1) и выборка по
+// диапазонам годов рождения и поступления. Хранится рядом с файлом данных
+// и обновляется при добавлении студента в текстовый файл.
+class StudentIndex {
+private:
+    // Столько записей накапливается вне упорядоченных списков до слияния
+    static const size_t MERGE_THRESHOLD = 4096;
 
-    // Имитация трех сессий
-    srand(time(nullptr));
-    for (Student& student : students) {
-        for (int i = 0; i < 3; ++i) {
-            std::vector<int> grades(4);
-            for (int& grade : grades) {
-                grade = rand() % 6 + 1; // Оценки от 1 до 6
+    std::string dataPath;
+    std::unique_ptr<StudentReader> reader;
+    std::unique_ptr<MappedFile> file;
+    StudentIndexHeader* header;
+    IndexSlot* slots;
+    IndexRecord* records;
+    uint32_t* byBirthYear;
+    uint32_t* byEnrollmentYear;
+
+    static size_t fileSizeFor(uint64_t slotCapacity, uint64_t recordCapacity) {
+        return sizeof(StudentIndexHeader) + slotCapacity * sizeof(IndexSlot)
+            + recordCapacity * (sizeof(IndexRecord) + 2 * sizeof(uint32_t));
+    }
+
+    void attach() {
+        char* base = file->writableData();
+        header = reinterpret_cast<StudentIndexHeader*>(base);
+        slots = reinterpret_cast<IndexSlot*>(base + sizeof(StudentIndexHeader));
+        records = reinterpret_cast<IndexRecord*>(slots + header->slotCapacity);
+        byBirthYear = reinterpret_cast<uint32_t*>(records + header->recordCapacity);
+        byEnrollmentYear = byBirthYear + header->recordCapacity;
+    }
+
+    // Отпечаток содержимого файла данных
+    void fingerprint(uint64_t& checksum, uint64_t& tail) const {
+        if (reader->isBinary()) {
+            checksum = reader->headerChecksum();
+            tail = 0;
+            return;
+        }
+        Checksum64 text;
+        text.update(reader->rawData(), reader->fileSize());
+        text.save(checksum, tail);
+    }
+
+    // Открытие существующего индекса; false, если его нет или он не
+    // соответствует файлу данных
+    bool open() {
+        try {
+            file.reset(new MappedFile(indexPath(dataPath), MapMode::Write));
+        }
+        catch (const std::runtime_error&) {
+            return false;
+        }
+        StudentIndexHeader stored;
+        if (file->size() < sizeof(stored)) {
+            return false;
+        }
+        std::memcpy(&stored, file->data(), sizeof(stored));
+        bool valid = std::memcmp(stored.magic, STUDENT_INDEX_MAGIC, sizeof(stored.magic)) == 0
+            && stored.version == STUDENT_INDEX_VERSION
+            && stored.slotCapacity != 0 && (stored.slotCapacity & (stored.slotCapacity - 1)) == 0
+            && stored.slotCapacity <= file->size() && stored.recordCapacity <= file->size()
+            && file->size() == fileSizeFor(stored.slotCapacity, stored.recordCapacity)
+            && stored.count <= stored.recordCapacity && stored.count < stored.slotCapacity
+            && stored.sortedCount <= stored.count
+            && stored.dataSize == reader->fileSize() && (stored.dataBinary != 0) == reader->isBinary();
+        if (valid) {
+            // Перезапись того же размера (например, после обмена двух
+            // студентов) размер не меняет - сравнивается содержимое
+            uint64_t checksum, tail;
+            fingerprint(checksum, tail);
+            valid = stored.dataChecksum == checksum && stored.dataChecksumTail == tail;
+        }
+        if (valid) {
+            attach();
+        }
+        return valid;
+    }
+
+    // Новый файл индекса с заданной емкостью и записями; ячейки заполняются
+    // по хэшам hashes[i] записи i
+    void create(uint64_t recordCapacity, const std::vector<IndexRecord>& source, const std::vector<uint64_t>& hashes) {
+        uint64_t slotCapacity = 1024;
+        while (slotCapacity < recordCapacity * 10 / 7 + 1) {
+            slotCapacity *= 2;
+        }
+        file.reset();
+        file.reset(new MappedFile(indexPath(dataPath), MapMode::Create, fileSizeFor(slotCapacity, recordCapacity)));
+        StudentIndexHeader fresh = {};
+        std::memcpy(fresh.magic, STUDENT_INDEX_MAGIC, sizeof(fresh.magic));
+        fresh.version = STUDENT_INDEX_VERSION;
+        fresh.slotCapacity = slotCapacity;
+        fresh.recordCapacity = recordCapacity;
+        fresh.dataBinary = reader->isBinary() ? 1 : 0;
+        std::memcpy(file->writableData(), &fresh, sizeof(fresh));
+        attach();
+
+        for (size_t i = 0; i < source.size(); ++i) {
+            records[i] = source[i];
+            byBirthYear[i] = byEnrollmentYear[i] = static_cast<uint32_t>(i);
+            insertSlot(hashes[i], i);
+        }
+        header->count = source.size();
+        mergeYears();
+        header->dataSize = reader->fileSize();
+    }
+
+    // Построение индекса по всему файлу данных
+    void rebuild() {
+        std::vector<IndexRecord> source;
+        std::vector<uint64_t> hashes;
+        reader->forEach([&](const StudentView& view, size_t) {
+            source.push_back(IndexRecord{ view.position, view.birthYear, view.enrollmentYear });
+            hashes.push_back(hashKey(view.recordBookNumber.data, view.recordBookNumber.size));
+        });
+        if (source.size() > UINT32_MAX) {
+            throw std::length_error("Too many students for the index");
+        }
+        create(std::max<uint64_t>(1024, source.size() * 2), source, hashes);
+        fingerprint(header->dataChecksum, header->dataChecksumTail);
+    }
+
+    // Перенос в файл вдвое большей емкости; ключи не перечитываются из данных
+    void grow() {
+        std::vector<IndexRecord> source(records, records + header->count);
+        std::vector<uint64_t> hashes(header->count);
+        for (uint64_t k = 0; k < header->slotCapacity; ++k) {
+            if (slots[k].record != 0) {
+                hashes[slots[k].record - 1] = slots[k].hash;
             }
-            student.recalculateAverageGrade(grades);
         }
+        create(header->recordCapacity * 2, source, hashes);
     }
 
+    StringRef keyOf(uint64_t record) const {
+        return reader->at(records[record].position).recordBookNumber;
+    }
+
+    // Номер записи с ключом key или -1
+    int64_t findRecord(const char* key, size_t size, uint64_t hash) const {
+        uint64_t mask = header->slotCapacity - 1;
+        for (uint64_t k = hash & mask;; k = (k + 1) & mask) {
+            const IndexSlot& slot = slots[k];
+            if (slot.record == 0) {
+                return -1;
+            }
+            if (slot.hash == hash) {
+                StringRef stored = keyOf(slot.record - 1);
+                if (stored.size == size && std::memcmp(stored.data, key, size) == 0) {
+                    return static_cast<int64_t>(slot.record - 1);
+                }
+            }
+        }
+    }
+
+    void insertSlot(uint64_t hash, uint64_t record) {
+        uint64_t mask = header->slotCapacity - 1;
+        uint64_t k = hash & mask;
+        for (; slots[k].record != 0; k = (k + 1) & mask) {
+            if (slots[k].hash == hash) {
+                StringRef stored = keyOf(slots[k].record - 1);
+                StringRef key = keyOf(record);
+                if (stored.size == key.size && std::memcmp(stored.data, key.data, key.size) == 0) {
+                    throw std::invalid_argument("Duplicate record book number: " + key.str());
+                }
+            }
+        }
+        slots[k].hash = hash;
+        slots[k].record = record + 1;
+    }
+
+    // Слияние записей [sortedCount, count) с упорядоченными списками по годам
+    void mergeYears() {
+        size_t sorted = static_cast<size_t>(header->sortedCount);
+        size_t count = static_cast<size_t>(header->count);
+        const IndexRecord* table = records;
+        auto mergeBy = [=](uint32_t* list, int32_t IndexRecord::* year) {
+            auto less = [=](uint32_t a, uint32_t b) {
+                return table[a].*year != table[b].*year ? table[a].*year < table[b].*year : a < b;
+            };
+            for (size_t i = sorted; i < count; ++i) {
+                list[i] = static_cast<uint32_t>(i);
+            }
+            std::sort(list + sorted, list + count, less);
+            std::inplace_merge(list, list + sorted, list + count, less);
+        };
+        mergeBy(byBirthYear, &IndexRecord::birthYear);
+        mergeBy(byEnrollmentYear, &IndexRecord::enrollmentYear);
+        header->sortedCount = count;
+    }
+
+    // Записи с годом из [from, to]: сначала упорядоченная часть, затем новые
+    template <typename Fn>
+    void forEachInRange(const uint32_t* list, int32_t IndexRecord::* year, int from, int to, Fn fn) const {
+        const IndexRecord* table = records;
+        const uint32_t* sortedEnd = list + header->sortedCount;
+        const uint32_t* p = std::lower_bound(list, sortedEnd, from, [=](uint32_t record, int value) {
+            return table[record].*year < value;
+        });
+        for (; p != sortedEnd && table[*p].*year <= to; ++p) {
+            fn(reader->at(table[*p].position));
+        }
+        for (uint64_t record = header->sortedCount; record < header->count; ++record) {
+            if (table[record].*year >= from && table[record].*year <= to) {
+                fn(reader->at(table[record].position));
+            }
+        }
+    }
+
+public:
+    static std::string indexPath(const std::string& dataPath) {
+        return dataPath + ".idx";
+    }
+
+    // Открытие индекса файла данных; если индекса нет или он устарел,
+    // он строится заново. Отсутствующий файл данных создается пустым.
+    explicit StudentIndex(const std::string& dataPath)
+        : dataPath(dataPath), header(nullptr), slots(nullptr), records(nullptr),
+        byBirthYear(nullptr), byEnrollmentYear(nullptr) {
+        std::ofstream(dataPath, std::ios::app);
+        reader.reset(new StudentReader(dataPath));
+        if (!open()) {
+            rebuild();
+        }
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(header->count);
+    }
+
+    const StudentReader& data() const {
+        return *reader;
+    }
+
+    // Поиск по номеру зачетки без копирования строк
+    bool find(const std::string& recordBook, StudentView& view) const {
+        int64_t record = findRecord(recordBook.data(), recordBook.size(), hashKey(recordBook.data(), recordBook.size()));
+        if (record < 0) {
+            return false;
+        }
+        view = reader->at(records[record].position);
+        return true;
+    }
+
+    // Студенты с годом рождения из [from, to]
+    template <typename Fn>
+    void forEachBirthYear(int from, int to, Fn fn) const {
+        forEachInRange(byBirthYear, &IndexRecord::birthYear, from, to, fn);
+    }
+
+    // Студенты с годом поступления из [from, to]
+    template <typename Fn>
+    void forEachEnrollmentYear(int from, int to, Fn fn) const {
+        forEachInRange(byEnrollmentYear, &IndexRecord::enrollmentYear, from, to, fn);
+    }
+
+    // Добавление студента в конец текстового файла данных через serialize()
+    // и в индекс. Двоичный файл дописывать нельзя: его пишет serializeAll().
+    void insert(const Student& student) {
+        if (reader->isBinary()) {
+            throw std::logic_error("Binary student files are rewritten with serializeAll, not appended");
+        }
+        const std::string& key = student.getRecordBookNumber();
+        uint64_t hash = hashKey(key.data(), key.size());
+        if (findRecord(key.data(), key.size(), hash) >= 0) {
+            throw std::invalid_argument("Duplicate record book number: " + key);
+        }
+
+        // Отображение закрывается на время записи: Windows не дает
+        // дописывать файл, открытый без FILE_SHARE_WRITE
+        uint64_t position = reader->fileSize();
+        Checksum64 checksum;
+        checksum.restore(header->dataChecksum, header->dataChecksumTail);
+        reader.reset();
+        student.serialize(dataPath);
+        reader.reset(new StudentReader(dataPath));
+        if (reader->fileSize() == position) {
+            throw std::runtime_error("Cannot write file: " + dataPath);
+        }
+
+        if (header->count == header->recordCapacity || (header->count + 1) * 10 > header->slotCapacity * 7) {
+            grow();
+        }
+        uint64_t record = header->count;
+        records[record] = IndexRecord{ position, student.getBirthYear(), student.getEnrollmentYear() };
+        insertSlot(hash, record);
+        header->count = record + 1;
+        if (header->count - header->sortedCount >= MERGE_THRESHOLD) {
+            mergeYears();
+        }
+        checksum.update(reader->rawData() + position, static_cast<size_t>(reader->fileSize() - position));
+        checksum.save(header->dataChecksum, header->dataChecksumTail);
+        // Размер данных записывается последним: прерванное добавление
+        // приведет к перестроению индекса при следующем открытии
+        header->dataSize = reader->fileSize();
+    }
+};
+
+// Запуск work(t) для t из [0, threads) в отдельных потоках
+template <typename Fn>
+void runThreads(unsigned threads, Fn work) {
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread& th : pool) {
+        th.join();
+    }
+}
+
+// Сортировка в threads потоках: каждый поток сортирует свой участок,
+// затем на каждом уровне пары соседних участков сливаются через буфер
+template <typename T, typename Less>
+void parallelSort(std::vector<T>& items, Less less, unsigned threads) {
+    const size_t count = items.size();
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, count)));
+    size_t step = (count + threads - 1) / threads;
+    runThreads(threads, [&](unsigned t) {
+        size_t begin = std::min(count, t * step), end = std::min(count, (t + 1) * step);
+        std::sort(items.begin() + begin, items.begin() + end, less);
+    });
+    if (threads == 1) {
+        return;
+    }
+
+    std::vector<T> buffer(count);
+    for (size_t width = step; width < count; width *= 2) {
+        unsigned pairs = static_cast<unsigned>((count + 2 * width - 1) / (2 * width));
+        runThreads(pairs, [&](unsigned p) {
+            size_t begin = p * 2 * width;
+            size_t middle = std::min(count, begin + width), end = std::min(count, begin + 2 * width);
+            std::merge(items.begin() + begin, items.begin() + middle, items.begin() + middle,
+                items.begin() + end, buffer.begin() + begin, less);
+        });
+        items.swap(buffer);
+    }
+}
+
+// Таблица студентов по столбцам: годы и баллы - в отдельных непрерывных
+// массивах, строки всех студентов - подряд в одной области памяти.
+// Рейтинг строится сортировкой пар (балл, номер строки), а не самих
+// записей, поэтому строки при сортировке не перемещаются.
+class StudentTable {
+private:
+    std::vector<int32_t> birthYears;
+    std::vector<int32_t> enrollmentYears;
+    std::vector<double> grades;
+    // Строки студента i: поле f занимает arena[stringStart[3i + f], stringStart[3i + f + 1])
+    std::string arena;
+    std::vector<uint64_t> stringStart;
+
+    // Элемент рейтинга: выше балл, при равенстве - меньший номер строки
+    struct RankEntry {
+        double grade;
+        uint32_t row;
+
+        bool operator<(const RankEntry& other) const {
+            return grade != other.grade ? grade > other.grade : row < other.row;
+        }
+    };
+
+    StringRef field(size_t row, size_t f) const {
+        if (row >= size()) {
+            throw std::out_of_range("Row out of range");
+        }
+        uint64_t begin = stringStart[3 * row + f];
+        return StringRef{ arena.data() + begin, static_cast<size_t>(stringStart[3 * row + f + 1] - begin) };
+    }
+
+    void appendRow(const char* name, size_t nameSize, const char* gender, size_t genderSize,
+        const char* recordBook, size_t recordBookSize, int birth, int enrollment, double grade) {
+        if (size() >= UINT32_MAX) {
+            throw std::length_error("Too many students for the table");
+        }
+        arena.append(name, nameSize);
+        stringStart.push_back(arena.size());
+        arena.append(gender, genderSize);
+        stringStart.push_back(arena.size());
+        arena.append(recordBook, recordBookSize);
+        stringStart.push_back(arena.size());
+        birthYears.push_back(birth);
+        enrollmentYears.push_back(enrollment);
+        grades.push_back(grade);
+    }
+
+    static unsigned threadCount(unsigned threads, size_t rows) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return rows < PARALLEL_THRESHOLD ? 1 : threads;
+    }
+
+public:
+    // Начиная с этого числа строк рейтинг строится в несколько потоков
+    static const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+    StudentTable() : stringStart(1, 0) {}
+
+    explicit StudentTable(const std::vector<Student>& students) : stringStart(1, 0) {
+        reserve(students.size(), 0);
+        for (const Student& student : students) {
+            push_back(student);
+        }
+    }
+
+    void reserve(size_t rows, size_t stringBytes) {
+        birthYears.reserve(rows);
+        enrollmentYears.reserve(rows);
+        grades.reserve(rows);
+        stringStart.reserve(3 * rows + 1);
+        arena.reserve(stringBytes);
+    }
+
+    void push_back(const Student& student) {
+        const std::string& name = student.getFullName();
+        const std::string& gender = student.getGender();
+        const std::string& recordBook = student.getRecordBookNumber();
+        appendRow(name.data(), name.size(), gender.data(), gender.size(), recordBook.data(), recordBook.size(),
+            student.getBirthYear(), student.getEnrollmentYear(), student.getAverageGrade());
+    }
+
+    void push_back(const StudentView& view) {
+        appendRow(view.fullName.data, view.fullName.size, view.gender.data, view.gender.size,
+            view.recordBookNumber.data, view.recordBookNumber.size, view.birthYear, view.enrollmentYear, view.averageGrade);
+    }
+
+    size_t size() const {
+        return grades.size();
+    }
+
+    void clear() {
+        birthYears.clear();
+        enrollmentYears.clear();
+        grades.clear();
+        arena.clear();
+        stringStart.assign(1, 0);
+    }
+
+    StringRef fullName(size_t row) const { return field(row, 0); }
+    StringRef gender(size_t row) const { return field(row, 1); }
+    StringRef recordBookNumber(size_t row) const { return field(row, 2); }
+    int birthYear(size_t row) const { return birthYears.at(row); }
+    int enrollmentYear(size_t row) const { return enrollmentYears.at(row); }
+    double averageGrade(size_t row) const { return grades.at(row); }
+
+    // Столбец средних баллов
+    const double* getGrades() const {
+        return grades.data();
+    }
+
+    // Строка таблицы как StudentView; position - номер строки
+    StudentView view(size_t row) const {
+        StudentView result;
+        result.fullName = fullName(row);
+        result.gender = gender(row);
+        result.birthYear = birthYears[row];
+        result.enrollmentYear = enrollmentYears[row];
+        result.recordBookNumber = recordBookNumber(row);
+        result.averageGrade = grades[row];
+        result.position = row;
+        return result;
+    }
+
+    Student toStudent(size_t row) const {
+        return Student(fullName(row).str(), gender(row).str(), birthYear(row), enrollmentYear(row),
+            recordBookNumber(row).str(), averageGrade(row));
+    }
+
+    // Номера строк по убыванию среднего балла (при равенстве - по номеру)
+    std::vector<uint32_t> rank(unsigned threads = 0) const {
+        const size_t rows = size();
+        std::vector<RankEntry> entries(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            entries[i] = RankEntry{ grades[i], static_cast<uint32_t>(i) };
+        }
+        parallelSort(entries, std::less<RankEntry>(), threadCount(threads, rows));
+
+        std::vector<uint32_t> order(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            order[i] = entries[i].row;
+        }
+        return order;
+    }
+
+    // Первые k строк рейтинга rank(). Каждый поток отбирает k лучших на
+    // своем участке кучей размера k, затем отборы объединяются.
+    std::vector<uint32_t> topK(size_t k, unsigned threads = 0) const {
+        const size_t rows = size();
+        k = std::min(k, rows);
+        threads = threadCount(threads, rows);
+        size_t step = (rows + threads - 1) / threads;
+        std::vector<std::vector<RankEntry>> heaps(threads);
+        runThreads(threads, [&](unsigned t) {
+            // Вершина кучи - худший из отобранных
+            std::vector<RankEntry>& heap = heaps[t];
+            heap.reserve(k + 1);
+            size_t end = std::min(rows, (t + 1) * step);
+            for (size_t i = std::min(rows, t * step); i < end && k > 0; ++i) {
+                RankEntry entry{ grades[i], static_cast<uint32_t>(i) };
+                if (heap.size() < k) {
+                    heap.push_back(entry);
+                    std::push_heap(heap.begin(), heap.end());
+                }
+                else if (entry < heap.front()) {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = entry;
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+        });
+
+        std::vector<RankEntry> best;
+        for (const std::vector<RankEntry>& heap : heaps) {
+            best.insert(best.end(), heap.begin(), heap.end());
+        }
+        std::partial_sort(best.begin(), best.begin() + k, best.end());
+        std::vector<uint32_t> order(k);
+        for (size_t i = 0; i < k; ++i) {
+            order[i] = best[i].row;
+        }
+        return order;
+    }
+};
+
+// Внешняя сортировка файла студентов, который не помещается в память.
+// Файл читается потоково (StudentReader), записи копятся в StudentTable,
+// пока оценка занятой памяти не достигнет memoryLimit; серия сортируется
+// в несколько потоков и сбрасывается во временный файл. Затем серии
+// сливаются деревом проигравших, а каждая серия читается двумя буферами:
+// пока один разбирается, следующий блок читается в фоне. Если серий
+// больше, чем помещается буферов, слияние идет в несколько проходов.
+// Результат записывается в текстовом формате serialize(); при равных
+// ключах сохраняется исходный порядок.
+enum class StudentSortKey {
+    AverageGrade,
+    FullName,
+    RecordBookNumber,
+    BirthYear,
+    EnrollmentYear
+};
+
+struct ExternalSortOptions {
+    size_t memoryLimit;        // Байт на серию и на буферы слияния
+    std::string tempDirectory; // Каталог временных файлов серий
+    StudentSortKey key;
+    bool descending;
+    unsigned threads;          // 0 - по числу ядер
+
+    ExternalSortOptions()
+        : memoryLimit(size_t(256) << 20), tempDirectory("."), key(StudentSortKey::AverageGrade), descending(true), threads(0) {}
+};
+
+// Заголовок записи во временном файле серии; за ним идут строки
+struct RunRecordHeader {
+    uint64_t sequence; // Номер записи во входном файле
+    double averageGrade;
+    int32_t birthYear;
+    int32_t enrollmentYear;
+    uint32_t nameSize;
+    uint32_t genderSize;
+    uint32_t recordBookSize;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(RunRecordHeader) == 40, "Run record header must take 40 bytes");
+
+inline int compareRefs(const StringRef& a, const StringRef& b) {
+    int result = std::memcmp(a.data, b.data, std::min(a.size, b.size));
+    return result != 0 ? result : (a.size < b.size ? -1 : (a.size > b.size ? 1 : 0));
+}
+
+// Порядок записей по ключу сортировки; при равенстве - по номеру во входном файле
+class StudentOrder {
+private:
+    StudentSortKey key;
+    bool descending;
+
+public:
+    StudentOrder(StudentSortKey key, bool descending) : key(key), descending(descending) {}
+
+    bool isNumeric() const {
+        return key != StudentSortKey::FullName && key != StudentSortKey::RecordBookNumber;
+    }
+
+    double number(const StudentView& view) const {
+        switch (key) {
+        case StudentSortKey::BirthYear:
+            return view.birthYear;
+        case StudentSortKey::EnrollmentYear:
+            return view.enrollmentYear;
+        default:
+            return view.averageGrade;
+        }
+    }
+
+    int compare(const StudentView& a, const StudentView& b) const {
+        int result;
+        if (isNumeric()) {
+            double x = number(a), y = number(b);
+            result = x < y ? -1 : (x > y ? 1 : 0);
+        }
+        else {
+            result = key == StudentSortKey::FullName ? compareRefs(a.fullName, b.fullName)
+                : compareRefs(a.recordBookNumber, b.recordBookNumber);
+        }
+        return descending ? -result : result;
+    }
+
+    bool before(const StudentView& a, uint64_t sequenceA, const StudentView& b, uint64_t sequenceB) const {
+        int result = compare(a, b);
+        return result != 0 ? result < 0 : sequenceA < sequenceB;
+    }
+};
+
+// Последовательная запись серии через большой буфер stdio
+class RunWriter {
+private:
+    std::string path;
+    std::FILE* file;
+    std::vector<char> buffer;
+
+public:
+    RunWriter(const std::string& path, size_t bufferSize) : path(path), file(std::fopen(path.c_str(), "wb")), buffer(bufferSize) {
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    }
+
+    RunWriter(const RunWriter&) = delete;
+    RunWriter& operator=(const RunWriter&) = delete;
+
+    ~RunWriter() {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    void write(const StudentView& view, uint64_t sequence) {
+        RunRecordHeader header = { sequence, view.averageGrade, view.birthYear, view.enrollmentYear,
+            static_cast<uint32_t>(view.fullName.size), static_cast<uint32_t>(view.gender.size),
+            static_cast<uint32_t>(view.recordBookNumber.size), 0 };
+        std::fwrite(&header, sizeof(header), 1, file);
+        std::fwrite(view.fullName.data, 1, view.fullName.size, file);
+        std::fwrite(view.gender.data, 1, view.gender.size, file);
+        std::fwrite(view.recordBookNumber.data, 1, view.recordBookNumber.size, file);
+    }
+
+    void close() {
+        bool failed = std::ferror(file) != 0;
+        failed = std::fclose(file) != 0 || failed;
+        file = nullptr;
+        if (failed) {
+            throw std::runtime_error("Cannot write file: " + path);
+        }
+    }
+};
+
+// Чтение серии двумя буферами: следующий блок читается асинхронно, пока
+// разбирается текущий. Строки текущей записи живут до следующего next().
+class RunReader {
+private:
+    std::FILE* file;
+    std::vector<char> buffers[2];
+    size_t filled[2];
+    int current;
+    size_t position;
+    bool lastBlock;  // Чтение, начатое последним, дошло до конца файла
+    std::future<size_t> pending;
+    std::string strings;
+
+    void startRead(int index) {
+        std::FILE* source = file;
+        char* target = buffers[index].data();
+        size_t size = buffers[index].size();
+        pending = std::async(std::launch::async, [source, target, size]() {
+            size_t read = std::fread(target, 1, size, source);
+            if (read < size && std::ferror(source)) {
+                throw std::runtime_error("Cannot read run file");
+            }
+            return read;
+        });
+    }
+
+    // Копирование size байт; false, если файл кончился раньше
+    bool readBytes(char* target, size_t size) {
+        while (size > 0) {
+            if (position == filled[current]) {
+                if (!pending.valid()) {
+                    return false;
+                }
+                int next = 1 - current;
+                filled[next] = pending.get();
+                lastBlock = filled[next] < buffers[next].size();
+                current = next;
+                position = 0;
+                if (!lastBlock) {
+                    startRead(1 - current);
+                }
+                if (filled[current] == 0) {
+                    return false;
+                }
+            }
+            size_t chunk = std::min(size, filled[current] - position);
+            std::memcpy(target, buffers[current].data() + position, chunk);
+            target += chunk;
+            size -= chunk;
+            position += chunk;
+        }
+        return true;
+    }
+
+public:
+    StudentView view;
+    uint64_t sequence;
+
+    RunReader(const std::string& path, size_t bufferSize)
+        : file(std::fopen(path.c_str(), "rb")), current(0), position(0), lastBlock(false), sequence(0) {
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        buffers[0].resize(bufferSize);
+        buffers[1].resize(bufferSize);
+        filled[0] = filled[1] = 0;
+        startRead(1);
+    }
+
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+
+    ~RunReader() {
+        if (pending.valid()) {
+            pending.wait();
+        }
+        std::fclose(file);
+    }
+
+    // Следующая запись в view и sequence; false в конце серии
+    bool next() {
+        RunRecordHeader header;
+        if (!readBytes(reinterpret_cast<char*>(&header), sizeof(header))) {
+            return false;
+        }
+        strings.resize(size_t(header.nameSize) + header.genderSize + header.recordBookSize);
+        if (!readBytes(&strings[0], strings.size())) {
+            throw std::runtime_error("Truncated run file");
+        }
+        const char* p = strings.data();
+        view.fullName = StringRef{ p, header.nameSize };
+        view.gender = StringRef{ p + header.nameSize, header.genderSize };
+        view.recordBookNumber = StringRef{ p + header.nameSize + header.genderSize, header.recordBookSize };
+        view.birthYear = header.birthYear;
+        view.enrollmentYear = header.enrollmentYear;
+        view.averageGrade = header.averageGrade;
+        view.position = 0;
+        sequence = header.sequence;
+        return true;
+    }
+};
+
+// Дерево проигравших над k источниками: во внутренних узлах хранятся
+// проигравшие, в tree[0] - победитель. После замены записи победителя
+// adjust() проходит только путь от его листа до корня: log2(k) сравнений.
+// beats(a, b) - запись источника a идет раньше записи b.
+template <typename Beats>
+class LoserTree {
+private:
+    std::vector<size_t> tree;
+    size_t k;
+    Beats beats;
+
+    // Номер k - воображаемый источник, который выигрывает у всех
+    bool wins(size_t a, size_t b) const {
+        if (a == k) {
+            return true;
+        }
+        if (b == k) {
+            return false;
+        }
+        return beats(a, b);
+    }
+
+public:
+    LoserTree(size_t k, Beats beats) : tree(std::max<size_t>(k, 1), k), k(k), beats(beats) {
+        for (size_t i = k; i-- > 0;) {
+            adjust(i);
+        }
+    }
+
+    size_t winner() const {
+        return tree[0];
+    }
+
+    void adjust(size_t source) {
+        for (size_t t = (source + k) / 2; t > 0; t /= 2) {
+            if (!wins(source, tree[t])) {
+                std::swap(source, tree[t]);
+            }
+        }
+        tree[0] = source;
+    }
+};
+
+// Временные файлы, удаляемые при выходе из области видимости
+class TempFiles {
+private:
+    std::string prefix;
+    size_t counter;
+
+public:
+    std::vector<std::string> paths;
+
+    explicit TempFiles(const std::string& directory) : counter(0) {
+        prefix = directory + "/student_run_"
+            + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_";
+    }
+
+    TempFiles(const TempFiles&) = delete;
+    TempFiles& operator=(const TempFiles&) = delete;
+
+    ~TempFiles() {
+        for (const std::string& path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    std::string create() {
+        paths.push_back(prefix + std::to_string(counter++) + ".tmp");
+        return paths.back();
+    }
+};
+
+// Слияние серий runs: sink(view, sequence) получает записи по порядку
+template <typename Sink>
+void mergeRuns(const std::vector<std::string>& runs, const StudentOrder& order, size_t bufferSize, Sink sink) {
+    std::vector<std::unique_ptr<RunReader>> readers;
+    std::vector<char> exhausted(runs.size());
+    for (size_t i = 0; i < runs.size(); ++i) {
+        readers.emplace_back(new RunReader(runs[i], bufferSize));
+        exhausted[i] = !readers[i]->next();
+    }
+    auto beats = [&](size_t a, size_t b) {
+        if (exhausted[a] || exhausted[b]) {
+            return !exhausted[a];
+        }
+        return order.before(readers[a]->view, readers[a]->sequence, readers[b]->view, readers[b]->sequence);
+    };
+    LoserTree<decltype(beats)> tree(runs.size(), beats);
+    while (!runs.empty()) {
+        size_t winner = tree.winner();
+        if (exhausted[winner]) {
+            break;
+        }
+        sink(readers[winner]->view, readers[winner]->sequence);
+        exhausted[winner] = !readers[winner]->next();
+        tree.adjust(winner);
+    }
+}
+
+// Сортировка файла inputPath (текстового или двоичного) в текстовый
+// файл outputPath; возвращает число серий первого прохода. outputPath
+// может совпадать с inputPath: выход открывается после чтения входа.
+size_t externalSort(const std::string& inputPath, const std::string& outputPath,
+    const ExternalSortOptions& options = ExternalSortOptions()) {
+    // Оценка памяти на запись сверх строк: смещения строк, годы, балл и
+    // элемент сортировки с буфером слияния
+    const size_t recordOverhead = 3 * sizeof(uint64_t) + 2 * sizeof(int32_t) + sizeof(double) + 32;
+    const size_t minBuffer = 64 << 10, maxBuffer = 4 << 20;
+    const size_t memoryLimit = std::max<size_t>(options.memoryLimit, 4 * minBuffer);
+    unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const StudentOrder order(options.key, options.descending);
+
+    TempFiles temp(options.tempDirectory);
+    std::vector<std::string> runs;
+
+    // Первый проход: серии, упорядоченные в памяти
+    {
+        StudentReader reader(inputPath);
+        StudentTable table;
+        size_t runBytes = 0;
+        uint64_t runStart = 0;
+
+        struct SortEntry {
+            double number;
+            uint32_t row;
+        };
+        auto flush = [&]() {
+            const size_t rows = table.size();
+            std::vector<SortEntry> entries(rows);
+            for (size_t i = 0; i < rows; ++i) {
+                entries[i] = SortEntry{ order.isNumeric() ? order.number(table.view(i)) : 0.0, static_cast<uint32_t>(i) };
+            }
+            const bool descending = options.descending;
+            if (order.isNumeric()) {
+                parallelSort(entries, [descending](const SortEntry& a, const SortEntry& b) {
+                    if (a.number != b.number) {
+                        return descending ? a.number > b.number : a.number < b.number;
+                    }
+                    return a.row < b.row;
+                }, rows >= StudentTable::PARALLEL_THRESHOLD ? threads : 1);
+            }
+            else {
+                const StudentTable& rowsTable = table;
+                parallelSort(entries, [&order, &rowsTable](const SortEntry& a, const SortEntry& b) {
+                    return order.before(rowsTable.view(a.row), a.row, rowsTable.view(b.row), b.row);
+                }, rows >= StudentTable::PARALLEL_THRESHOLD ? threads : 1);
+            }
+
+            runs.push_back(temp.create());
+            RunWriter writer(runs.back(), maxBuffer);
+            for (const SortEntry& entry : entries) {
+                writer.write(table.view(entry.row), runStart + entry.row);
+            }
+            writer.close();
+            runStart += rows;
+            table.clear();
+            runBytes = 0;
+        };
+
+        reader.forEach([&](const StudentView& view, size_t) {
+            table.push_back(view);
+            runBytes += view.fullName.size + view.gender.size + view.recordBookNumber.size + recordOverhead;
+            if (runBytes >= memoryLimit) {
+                flush();
+            }
+        });
+        if (table.size() > 0) {
+            flush();
+        }
+    }
+    const size_t initialRuns = runs.size();
+
+    // Промежуточные проходы, пока серий больше, чем буферов в памяти
+    const size_t maxFanIn = std::max<size_t>(2, memoryLimit / (2 * minBuffer));
+    while (runs.size() > maxFanIn) {
+        std::vector<std::string> merged;
+        for (size_t first = 0; first < runs.size(); first += maxFanIn) {
+            std::vector<std::string> group(runs.begin() + first, runs.begin() + std::min(runs.size(), first + maxFanIn));
+            merged.push_back(temp.create());
+            size_t bufferSize = std::min(maxBuffer, std::max(minBuffer, memoryLimit / (2 * (group.size() + 1))));
+            RunWriter writer(merged.back(), bufferSize);
+            mergeRuns(group, order, bufferSize, [&writer](const StudentView& view, uint64_t sequence) {
+                writer.write(view, sequence);
+            });
+            writer.close();
+            for (const std::string& path : group) {
+                std::remove(path.c_str());
+            }
+        }
+        runs.swap(merged);
+    }
+
+    // Последний проход: запись в формате serialize()
+    std::ofstream outFile;
+    std::vector<char> outBuffer(maxBuffer);
+    outFile.rdbuf()->pubsetbuf(outBuffer.data(), static_cast<std::streamsize>(outBuffer.size()));
+    outFile.open(outputPath, std::ios::trunc);
+    if (!outFile.is_open()) {
+        throw std::runtime_error("Cannot open file: " + outputPath);
+    }
+    size_t bufferSize = std::min(maxBuffer, std::max(minBuffer, memoryLimit / (2 * std::max<size_t>(1, runs.size()))));
+    mergeRuns(runs, order, bufferSize, [&outFile](const StudentView& view, uint64_t) {
+        outFile << view.fullName << "\n" << view.gender << "\n" << view.birthYear << "\n" << view.enrollmentYear << "\n"
+            << view.recordBookNumber << "\n" << view.averageGrade << "\n";
+    });
+    outFile.close();
+    if (!outFile) {
+        throw std::runtime_error("Cannot write file: " + outputPath);
+    }
+    return initialRuns;
+}
+
+// Генератор оценок: splitmix64, у каждого блока студентов свой поток
+class GradeRandom {
+private:
+    uint64_t state;
+
+public:
+    explicit GradeRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Равномерно от 1 до 6 (умножение вместо остатка от деления)
+    int grade() {
+        return 1 + static_cast<int>(((next() >> 32) * 6) >> 32);
+    }
+};
+
+// Имитация sessions сессий по gradesPerSession оценок у каждого студента.
+// Список делится на блоки по SESSION_BLOCK студентов, и генератор каждого
+// блока получает свое начальное значение из seed и номера блока. Потоки
+// разбирают блоки по очереди, поэтому оценки не зависят ни от числа
+// потоков, ни от порядка их работы. Возвращает число студентов в секунду.
+const size_t SESSION_BLOCK = 1024;
+
+double simulateSessions(std::vector<Student>& roster, int sessions, int gradesPerSession, uint64_t seed, unsigned threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t blocks = (roster.size() + SESSION_BLOCK - 1) / SESSION_BLOCK;
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, blocks)));
+
+    std::atomic<size_t> nextBlock(0);
+    auto work = [&]() {
+        for (size_t block = nextBlock++; block < blocks; block = nextBlock++) {
+            GradeRandom random(GradeRandom(seed ^ (block * 0xD1B54A32D192ED03ULL)).next());
+            size_t end = std::min(roster.size(), (block + 1) * SESSION_BLOCK);
+            for (size_t i = block * SESSION_BLOCK; i < end; ++i) {
+                for (int session = 0; session < sessions; ++session) {
+                    int sum = 0;
+                    for (int k = 0; k < gradesPerSession; ++k) {
+                        sum += random.grade();
+                    }
+                    roster[i].addSession(sum, gradesPerSession);
+                }
+            }
+        }
+    };
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return roster.size() / elapsed.count();
+}
+
+// Случайный список студентов для замеров
+std::vector<Student> makeRoster(size_t count, uint64_t seed = 42) {
+    static const char* const firstNames[] = { "Alice", "Bob", "Carol", "David", "Eva", "Frank", "Grace", "Henry" };
+    static const char* const lastNames[] = { "Smith", "Johnson", "White", "Brown", "Taylor", "Miller", "Wilson", "Moore" };
+    auto next = [&seed]() {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>(seed >> 33);
+    };
+
+    std::vector<Student> students;
+    students.reserve(count);
+    char recordBook[16];
+    for (size_t i = 0; i < count; ++i) {
+        int first = next() % 8;
+        int birth = 1995 + next() % 12;
+        std::snprintf(recordBook, sizeof(recordBook), "%c%c%07u", 'A' + next() % 26, 'A' + next() % 26, static_cast<unsigned>(i % 10000000));
+        students.emplace_back(std::string(firstNames[first]) + " " + lastNames[next() % 8], first % 2 == 0 ? "Female" : "Male",
+            birth, birth + 17 + next() % 3, recordBook, 1.0 + (next() % 501) / 100.0);
+    }
+    return students;
+}
+
+// Запись count студентов: по одному через serialize() в текстовый файл
+// и всех сразу через serializeAll() в двоичный
+void runSerializeBenchmark(size_t count = 100000) {
+    std::vector<Student> students = makeRoster(count);
+    const std::string textPath = "bench_students.txt";
+    const std::string binaryPath = "bench_students.bin";
+    std::remove(textPath.c_str());
+
+    auto seconds = [](std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+    auto fileSize = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return static_cast<double>(file.tellg()) / (1 << 20);
+    };
+
+    auto begin = std::chrono::steady_clock::now();
+    for (const Student& student : students) {
+        student.serialize(textPath);
+    }
+    double text = seconds(begin);
+
+    begin = std::chrono::steady_clock::now();
+    Student::serializeAll(students, binaryPath);
+    double binary = seconds(begin);
+
+    std::cout << std::fixed << std::setprecision(3) << count << " students" << std::endl;
+    std::cout << "serialize() per student: " << text << " s, " << fileSize(textPath) << " MiB" << std::endl;
+    std::cout << "serializeAll():          " << binary << " s, " << fileSize(binaryPath) << " MiB ("
+        << text / binary << "x faster)" << std::endl;
+
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+}
+
+// Чтение count студентов: построчно через std::getline с копированием
+// строк, как в deserialize(), и через StudentReader из текстового и
+// двоичного файлов в один поток и во все потоки
+void runReadBenchmark(size_t count = 1000000) {
+    std::vector<Student> students = makeRoster(count);
+    const std::string textPath = "bench_students.txt";
+    const std::string binaryPath = "bench_students.bin";
+    {
+        std::ofstream outFile(textPath, std::ios::binary);
+        for (const Student& student : students) {
+            outFile << student.getFullName() << "\n" << student.getGender() << "\n" << student.getBirthYear() << "\n"
+                << student.getEnrollmentYear() << "\n" << student.getRecordBookNumber() << "\n"
+                << student.getAverageGrade() << "\n";
+        }
+    }
+    Student::serializeAll(students, binaryPath);
+    students.clear();
+    students.shrink_to_fit();
+
+    auto seconds = [](std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+    auto report = [count](const char* title, double time, double sum) {
+        std::cout << std::setw(26) << title << ": " << std::setw(8) << time * 1e3 << " ms, "
+            << std::setw(8) << count / time / 1e6 << " M records/s (sum " << sum << ")" << std::endl;
+    };
+    std::cout << std::fixed << std::setprecision(2) << count << " students" << std::endl;
+
+    auto begin = std::chrono::steady_clock::now();
+    double sum = 0;
+    {
+        std::ifstream inFile(textPath);
+        std::string name, gender, recordBook;
+        int birth, enrollment;
+        double grade;
+        while (std::getline(inFile, name) && std::getline(inFile, gender) && inFile >> birth >> enrollment) {
+            inFile.ignore();
+            std::getline(inFile, recordBook);
+            inFile >> grade;
+            inFile.ignore();
+            sum += grade;
+        }
+    }
+    report("getline, text", seconds(begin), sum);
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (const std::string& path : { textPath, binaryPath }) {
+        const char* format = path == textPath ? "text" : "binary";
+        StudentReader reader(path);
+
+        begin = std::chrono::steady_clock::now();
+        sum = 0;
+        reader.forEach([&sum](const StudentView& view, size_t) {
+            sum += view.averageGrade;
+        });
+        report((std::string("views, ") + format).c_str(), seconds(begin), sum);
+
+        begin = std::chrono::steady_clock::now();
+        std::vector<double> partial(count);
+        reader.forEachParallel([&partial](const StudentView& view, size_t index) {
+            partial[index] = view.averageGrade;
+        }, threads);
+        double time = seconds(begin);
+        sum = 0;
+        for (double grade : partial) {
+            sum += grade;
+        }
+        report((std::string("views, ") + format + ", " + std::to_string(threads) + " threads").c_str(), time, sum);
+
+        begin = std::chrono::steady_clock::now();
+        std::vector<Student> all = reader.readAll(threads);
+        report((std::string("readAll, ") + format).c_str(), seconds(begin), static_cast<double>(all.size()));
+    }
+
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+}
+
+// Поиск по номеру зачетки: перебор std::vector<Student> и StudentIndex
+// над двоичным файлом из count студентов; построение и открытие индекса,
+// выборка по годам и добавление в текстовый файл
+void runIndexBenchmark(size_t count = 1000000) {
+    std::vector<Student> students = makeRoster(count);
+    const std::string binaryPath = "bench_students.bin";
+    const std::string textPath = "bench_students.txt";
+    Student::serializeAll(students, binaryPath);
+    std::remove(StudentIndex::indexPath(binaryPath).c_str());
+
+    auto seconds = [](std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+    std::cout << std::fixed << std::setprecision(2) << count << " students" << std::endl;
+
+    const size_t lookups = 1000000;
+    std::vector<std::string> keys(lookups);
+    uint64_t state = 7;
+    for (std::string& key : keys) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        key = students[(state >> 33) % count].getRecordBookNumber();
+    }
+
+    // Перебор слишком медленный для всех ключей: замер на первой сотне
+    const size_t scans = 100;
+    auto begin = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (size_t k = 0; k < scans; ++k) {
+        for (const Student& student : students) {
+            if (student.getRecordBookNumber() == keys[k]) {
+                ++found;
+                break;
+            }
+        }
+    }
+    double scanTime = seconds(begin) / scans;
+    std::cout << "linear scan:      " << std::setw(10) << 1 / scanTime << " lookups/s (" << found << " found)" << std::endl;
+
+    begin = std::chrono::steady_clock::now();
+    {
+        StudentIndex index(binaryPath);
+    }
+    std::cout << "index build:      " << std::setw(10) << seconds(begin) * 1e3 << " ms" << std::endl;
+
+    begin = std::chrono::steady_clock::now();
+    StudentIndex index(binaryPath);
+    std::cout << "index open:       " << std::setw(10) << seconds(begin) * 1e3 << " ms" << std::endl;
+
+    begin = std::chrono::steady_clock::now();
+    found = 0;
+    StudentView view;
+    for (const std::string& key : keys) {
+        found += index.find(key, view) ? 1 : 0;
+    }
+    double time = seconds(begin);
+    std::cout << "index lookup:     " << std::setw(10) << lookups / time << " lookups/s (" << found << " found, "
+        << scanTime * lookups / time << "x faster)" << std::endl;
+
+    begin = std::chrono::steady_clock::now();
+    size_t inRange = 0;
+    index.forEachBirthYear(2000, 2001, [&inRange](const StudentView&) {
+        ++inRange;
+    });
+    std::cout << "birth 2000-2001:  " << std::setw(10) << seconds(begin) * 1e3 << " ms (" << inRange << " students)" << std::endl;
+
+    const size_t inserts = 10000;
+    std::remove(textPath.c_str());
+    std::remove(StudentIndex::indexPath(textPath).c_str());
+    StudentIndex textIndex(textPath);
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < inserts; ++i) {
+        textIndex.insert(students[i]);
+    }
+    time = seconds(begin);
+    std::cout << "text insert:      " << std::setw(10) << inserts / time << " students/s ("
+        << textIndex.size() << " indexed)" << std::endl;
+
+    std::remove(binaryPath.c_str());
+    std::remove(StudentIndex::indexPath(binaryPath).c_str());
+    std::remove(textPath.c_str());
+    std::remove(StudentIndex::indexPath(textPath).c_str());
+}
+
+// Рейтинг count студентов: std::sort по std::vector<Student> и
+// StudentTable в один поток, во все потоки и отбор первой сотни
+void runTableBenchmark(size_t count = 1000000) {
+    std::vector<Student> students = makeRoster(count);
+    auto seconds = [](std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+    auto report = [](const char* title, double time, double best) {
+        std::cout << std::setw(24) << title << ": " << std::setw(8) << time * 1e3 << " ms (best " << best << ")" << std::endl;
+    };
+    std::cout << std::fixed << std::setprecision(2) << count << " students" << std::endl;
+
+    std::vector<Student> sorted = students;
+    auto begin = std::chrono::steady_clock::now();
+    std::sort(sorted.begin(), sorted.end(), [](const Student& a, const Student& b) {
+        return a.getAverageGrade() > b.getAverageGrade();
+    });
+    report("std::sort of Student", seconds(begin), sorted[0].getAverageGrade());
+
+    begin = std::chrono::steady_clock::now();
+    StudentTable table(students);
+    report("StudentTable build", seconds(begin), 0);
+
+    begin = std::chrono::steady_clock::now();
+    std::vector<uint32_t> order = table.rank(1);
+    report("rank, 1 thread", seconds(begin), table.averageGrade(order[0]));
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    begin = std::chrono::steady_clock::now();
+    order = table.rank(threads);
+    report(("rank, " + std::to_string(threads) + " threads").c_str(), seconds(begin), table.averageGrade(order[0]));
+
+    begin = std::chrono::steady_clock::now();
+    std::vector<uint32_t> top = table.topK(100, threads);
+    report("topK(100)", seconds(begin), table.averageGrade(top[0]));
+
+    bool same = std::equal(top.begin(), top.end(), order.begin());
+    std::cout << "topK matches rank: " << (same ? "yes" : "no") << std::endl;
+}
+
+// Имитация трех сессий для count студентов в 1, 2, 4 ... потоках;
+// контрольная сумма средних баллов должна совпадать при любом числе потоков
+void runSessionBenchmark(size_t count = 1000000) {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::fixed << std::setprecision(2) << count << " students, 3 sessions of 4 grades" << std::endl;
+    for (unsigned threads = 1;; threads = std::min(maxThreads, threads * 2)) {
+        std::vector<Student> roster = makeRoster(count);
+        double rate = simulateSessions(roster, 3, 4, 2024, threads);
+        uint64_t checksum = 0;
+        for (const Student& student : roster) {
+            checksum = checksum * 31 + static_cast<uint64_t>(student.getGradeSum());
+        }
+        std::cout << std::setw(4) << threads << " threads: " << std::setw(8) << rate / 1e6
+            << " M students/s (checksum " << checksum << ")" << std::endl;
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+}
+
+// Сортировка файла из count студентов по убыванию балла: в памяти
+// (readAll и std::stable_sort) и внешней сортировкой с разными лимитами
+// памяти; файлы результатов должны совпадать побайтно
+void runExternalSortBenchmark(size_t count = 1000000) {
+    const std::string inputPath = "bench_students.bin";
+    const std::string memoryPath = "bench_sorted_memory.txt";
+    const std::string externalPath = "bench_sorted_external.txt";
+    Student::serializeAll(makeRoster(count), inputPath);
+
+    auto seconds = [](std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+    auto readFile = [](const std::string& path) {
+        std::ifstream inFile(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    };
+    std::cout << std::fixed << std::setprecision(2) << count << " students" << std::endl;
+
+    auto begin = std::chrono::steady_clock::now();
+    {
+        std::vector<Student> students = StudentReader(inputPath).readAll();
+        std::stable_sort(students.begin(), students.end(), [](const Student& a, const Student& b) {
+            return a.getAverageGrade() > b.getAverageGrade();
+        });
+        std::ofstream outFile(memoryPath);
+        for (const Student& student : students) {
+            outFile << student.getFullName() << "\n" << student.getGender() << "\n" << student.getBirthYear() << "\n"
+                << student.getEnrollmentYear() << "\n" << student.getRecordBookNumber() << "\n"
+                << student.getAverageGrade() << "\n";
+        }
+    }
+    std::cout << std::setw(22) << "in memory" << ": " << std::setw(8) << seconds(begin) * 1e3 << " ms" << std::endl;
+    const std::string expected = readFile(memoryPath);
+
+    const size_t limits[] = { size_t(1) << 30, size_t(16) << 20, size_t(1) << 20 };
+    for (size_t limit : limits) {
+        ExternalSortOptions options;
+        options.memoryLimit = limit;
+        begin = std::chrono::steady_clock::now();
+        size_t runs = externalSort(inputPath, externalPath, options);
+        double time = seconds(begin);
+        std::cout << std::setw(14) << (limit >> 20) << " MiB limit: " << std::setw(8) << time * 1e3 << " ms, "
+            << std::setw(4) << runs << " runs, matches: " << (readFile(externalPath) == expected ? "yes" : "no") << std::endl;
+    }
+
+    std::remove(inputPath.c_str());
+    std::remove(memoryPath.c_str());
+    std::remove(externalPath.c_str());
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench-serialize") == 0) {
+        runSerializeBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-read") == 0) {
+        runReadBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-index") == 0) {
+        runIndexBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-table") == 0) {
+        runTableBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-sessions") == 0) {
+        runSessionBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-external-sort") == 0) {
+        runExternalSortBenchmark();
+        return 0;
+    }
+
+    // Массив из трех студентов
+    std::vector<Student> students(3);
+
+    // Установка данных через сеттеры
+    students[0].setFullName("Alice Smith");
+    students[0].setGender("Female");
+    students[0].setBirthYear(2002);
+    students[0].setEnrollmentYear(2020);
+    students[0].setRecordBookNumber("AB123");
+    students[0].setAverageGrade(4.5);
+
+    students[1].setFullName("Bob Johnson");
+    students[1].setGender("Male");
+    students[1].setBirthYear(2001);
+    students[1].setEnrollmentYear(2019);
+    students[1].setRecordBookNumber("BC234");
+    students[1].setAverageGrade(3.8);
+
+    students[2].setFullName("Carol White");
+    students[2].setGender("Female");
+    students[2].setBirthYear(2000);
+    students[2].setEnrollmentYear(2018);
+    students[2].setRecordBookNumber("CD345");
+    students[2].setAverageGrade(4.2);
+
+    // Студент в куче
+    Student* dynamicStudent = new Student("David Brown", "Male", 2003, 2021, "DE456", 4.7);
+
+    // Имитация трех сессий по четыре оценки от 1 до 6; средний балл - по всем сессиям
+    simulateSessions(students, 3, 4, static_cast<uint64_t>(time(nullptr)));
+
     // Сортировка студентов по убыванию среднего балла
     std::sort(students.begin(), students.end(), [](const Student& a, const Student& b) {
         return a.getAverageGrade() > b.getAverageGrade();